@@ -0,0 +1,61 @@
+#pragma once
+#include <Arduino.h>
+#include <type_traits>
+#include "Appliance/AirConditioner/StatusData.h"
+
+namespace dudanov {
+namespace midea {
+namespace ac {
+
+/// Bits of `AcState::changeMask`
+enum StateChange : uint16_t {
+  CHANGE_MODE = 1 << 0,
+  CHANGE_PRESET = 1 << 1,
+  CHANGE_FAN_MODE = 1 << 2,
+  CHANGE_SWING_MODE = 1 << 3,
+  CHANGE_TARGET_TEMP = 1 << 4,
+  CHANGE_INDOOR_TEMP = 1 << 5,
+  CHANGE_OUTDOOR_TEMP = 1 << 6,
+  CHANGE_HUMIDITY_SETPOINT = 1 << 7,
+  CHANGE_POWER_USAGE = 1 << 8,
+};
+
+/// Air conditioner state snapshot. Plain data without padding: may be copied with `memcpy`,
+/// passed through RTOS queues or written to a buffer as is.
+struct AcState {
+  /// Time of last update, ms
+  uint32_t timestamp{};
+  /// Total power usage, 0.1 kWh
+  uint32_t powerUsage{};
+  /// Sequence number. Incremented on every change.
+  uint16_t sequence{};
+  /// `StateChange` bits changed by last update
+  uint16_t changeMask{};
+  /// Target temperature, 0.1 °C
+  int16_t targetTemp{};
+  /// Indoor temperature, 0.1 °C
+  int16_t indoorTemp{};
+  /// Outdoor temperature, 0.1 °C
+  int16_t outdoorTemp{};
+  Mode mode{Mode::MODE_OFF};
+  Preset preset{Preset::PRESET_NONE};
+  FanMode fanMode{FanMode::FAN_AUTO};
+  SwingMode swingMode{SwingMode::SWING_OFF};
+  /// Humidity setpoint, %
+  uint8_t humiditySetpoint{};
+  uint8_t reserved{};
+
+  float getTargetTemp() const { return static_cast<float>(this->targetTemp) / 10.0F; }
+  float getIndoorTemp() const { return static_cast<float>(this->indoorTemp) / 10.0F; }
+  float getOutdoorTemp() const { return static_cast<float>(this->outdoorTemp) / 10.0F; }
+  float getPowerUsage() const { return static_cast<float>(this->powerUsage) / 10.0F; }
+  /// Mask of `StateChange` bits which differ from `other`. Service fields are not compared.
+  uint16_t diff(const AcState &other) const;
+};
+
+static_assert(std::is_trivially_copyable<AcState>::value, "AcState must be trivially copyable.");
+static_assert(sizeof(AcState) == 24, "AcState must have no padding.");
+
+}  // namespace ac
+}  // namespace midea
+}  // namespace dudanov
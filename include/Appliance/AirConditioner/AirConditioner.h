@@ -1,64 +1,138 @@
 #pragma once
 #include <Arduino.h>
-#include "Appliance/ApplianceBase.h"
+#include "Appliance/Appliance.h"
+#include "Appliance/AirConditioner/AcState.h"
 #include "Appliance/AirConditioner/Capabilities.h"
+#include "Appliance/AirConditioner/EnergyMeter.h"
 #include "Appliance/AirConditioner/StatusData.h"
+#include "Appliance/AirConditioner/TimeSeries.h"
 #include "Helpers/Helpers.h"
+#include "Helpers/Storage.h"
 
 namespace dudanov {
 namespace midea {
 namespace ac {
 
-// Air conditioner control command
+// Air conditioner control command. All changes are applied together by minimal frame sequence.
 struct Control {
+  /// Target temperature, °C. Compatibility wrapper of `targetTempTenths`, which has priority if both are set.
   Optional<float> targetTemp{};
   Optional<Mode> mode{};
   Optional<Preset> preset{};
   Optional<FanMode> fanMode{};
   Optional<SwingMode> swingMode{};
+  /// Beeper feedback, same as `setBeeper()`
+  Optional<bool> beeper{};
+  /// Toggle LED display
+  bool displayToggle{};
+  /// Target temperature, 0.1 °C
+  Optional<int16_t> targetTempTenths{};
+  /// Target temperature from either field, 0.1 °C
+  Optional<int16_t> getTargetTempTenths() const;
+  /// Accumulate later changes of `other`. Display toggles cancel each other.
+  Control &merge(const Control &other);
 };
 
-class AirConditioner : public ApplianceBase {
+/// Completion of control command. Argument is `true` if all its frames are acknowledged.
+using ControlCallback = Delegate<void(bool)>;
+
+/// Typed state observer. Receives new state snapshot.
+using StateObserver = Delegate<void(const AcState &)>;
+/// Clock source. Returns time in seconds, e.g. UNIX time.
+using ClockSource = Delegate<uint32_t()>;
+
+/// Air conditioner descriptor: status polled on every idle period, power usage every 30 s
+struct AcDescriptor {
+  static constexpr ApplianceType TYPE = AIR_CONDITIONER;
+  using State = AcState;
+  enum : uint8_t { QUERY_STATUS, QUERY_POWER };
+  static FrameData queryStatus() { return QueryStateData{}; }
+  static FrameData queryPower() { return QueryPowerData{}; }
+  static bool decodeStatus(const uint8_t *data, uint8_t size, AcState &state);
+  static bool decodePower(const uint8_t *data, uint8_t size, AcState &state);
+  static constexpr QuerySpec<AcState> QUERIES[] = {
+    {queryStatus, 0xC0, decodeStatus, 0},
+    {queryPower, 0xC1, decodePower, 30000},
+  };
+};
+
+class AirConditioner : public Appliance<AcDescriptor> {
  public:
-  AirConditioner() : ApplianceBase(AIR_CONDITIONER) {}
   void m_setup() override;
-  void m_onIdle() override { this->m_getStatus(); }
-  void control(const Control &control);
+  /// Apply control command. Changes are sent in one SET_STATUS(0x40) frame. Mode change with preset needs two
+  /// frames, display toggle adds TOGGLE_LIGHT(0x41) frame: they are sent as group. `onComplete` is called once for
+  /// whole command, also if it is dropped because previous command is still in progress.
+  void control(const Control &control, ControlCallback onComplete = nullptr);
   void setPowerState(bool state);
-  bool getPowerState() const { return this->m_mode != Mode::MODE_OFF; }
-  void togglePowerState() { this->setPowerState(this->m_mode == Mode::MODE_OFF); }
-  float getTargetTemp() const { return this->m_targetTemp; }
-  float getIndoorTemp() const { return this->m_indoorTemp; }
-  float getOutdoorTemp() const { return this->m_outdoorTemp; }
-  float getIndoorHum() const { return this->m_indoorHumidity; }
-  float getPowerUsage() const { return this->m_powerUsage; }
-  Mode getMode() const { return this->m_mode; }
-  SwingMode getSwingMode() const { return this->m_swingMode; }
-  FanMode getFanMode() const { return this->m_fanMode; }
-  Preset getPreset() const { return this->m_preset; }
+  bool getPowerState() const { return this->m_state.mode != Mode::MODE_OFF; }
+  void togglePowerState() { this->setPowerState(this->m_state.mode == Mode::MODE_OFF); }
+  float getTargetTemp() const { return this->m_state.getTargetTemp(); }
+  float getIndoorTemp() const { return this->m_state.getIndoorTemp(); }
+  float getOutdoorTemp() const { return this->m_state.getOutdoorTemp(); }
+  float getIndoorHum() const { return static_cast<float>(this->m_state.humiditySetpoint); }
+  float getPowerUsage() const { return this->m_state.getPowerUsage(); }
+  Mode getMode() const { return this->m_state.mode; }
+  SwingMode getSwingMode() const { return this->m_state.swingMode; }
+  FanMode getFanMode() const { return this->m_state.fanMode; }
+  Preset getPreset() const { return this->m_state.preset; }
   const Capabilities &getCapabilities() const { return this->m_capabilities; }
   void displayToggle() { this->m_displayToggle(); }
+  /// Set storage for capabilities cache. With enabled autoconf, capabilities are restored from cache on setup
+  /// and verified by 0xB5 requests in background, unless serial number of appliance is known (`setSerialNumber()`)
+  /// and matches cached one. Changed capabilities replace cached ones.
+  void setCapabilitiesStorage(Storage *storage, const char *key = "ac_caps") {
+    this->m_capabilitiesStorage = storage;
+    this->m_capabilitiesKey = key;
+  }
+  /// Set clock for energy metering. Hourly buckets are aligned to this clock. Default: uptime.
+  void setClock(ClockSource clock) { this->m_clock = clock; }
+  /// Hourly energy accumulator
+  const EnergyMeter &getEnergyMeter() const { return this->m_energyMeter; }
+  /// Set storage for energy accumulator. It is restored on setup and saved on every new hour. Requires wall clock
+  /// set by `setClock()` before setup: buckets of uptime clock are neither restored nor saved.
+  void setEnergyStorage(Storage *storage, const char *key = "ac_energy") {
+    this->m_energyStorage = storage;
+    this->m_energyKey = key;
+  }
+  /// Set history store fed by every received status. Uses clock of `setClock()`.
+  void setTimeSeries(TimeSeries *series) { this->m_timeSeries = series; }
+  MemoryUsage getMemoryUsage() const override;
  protected:
-  void m_getPowerUsage();
-  void m_getCapabilities();
-  void m_getStatus();
-  void m_setStatus(StatusData status);
+  void m_getCapabilities(RequestPriority priority = PRIORITY_QUERY);
+  bool m_restoreCapabilities();
+  void m_saveCapabilities();
+  // Commit capabilities read by 0xB5 requests
+  void m_onCapabilities();
+  uint32_t m_fingerprint() const;
+  uint32_t m_getTime() const { return (this->m_clock != nullptr) ? this->m_clock() : TimerManager::ms() / 1000; }
+  void m_addEnergySample(uint32_t counter);
+  void m_restoreEnergy();
+  void m_onDecoded(uint8_t idx, const uint8_t *data, uint8_t size, AcState &state) override;
+  // Enqueue frame of control command. Last frame completes command.
+  void m_queueControl(FrameType type, FrameData data, bool isLast);
+  void m_onControlSuccess() { this->m_finishControl(true); }
+  void m_onControlError() { this->m_finishControl(false); }
+  // Call completion callback once per command
+  void m_finishControl(bool success);
   void m_displayToggle();
-  ResponseStatus m_readStatus(FrameData data);
   Capabilities m_capabilities{};
-  Timer m_powerUsageTimer;
-  float m_indoorHumidity{};
-  float m_indoorTemp{};
-  float m_outdoorTemp{};
-  float m_targetTemp{};
-  float m_powerUsage{};
-  Mode m_mode{Mode::MODE_OFF};
-  Preset m_preset{Preset::PRESET_NONE};
-  FanMode m_fanMode{FanMode::FAN_AUTO};
-  SwingMode m_swingMode{SwingMode::SWING_OFF};
+  // Capabilities being read by 0xB5 requests
+  Capabilities m_newCapabilities{};
+  Storage *m_capabilitiesStorage{};
+  const char *m_capabilitiesKey{};
+  // Appliance fingerprint of cached capabilities
+  uint32_t m_capabilitiesTag{};
+  // Cached capabilities must be verified by fingerprint
+  bool m_verifyCapabilities{};
+  EnergyMeter m_energyMeter{};
+  ClockSource m_clock{};
+  Storage *m_energyStorage{};
+  const char *m_energyKey{};
+  TimeSeries *m_timeSeries{};
   Preset m_lastPreset{Preset::PRESET_NONE};
   StatusData m_status{};
   bool m_sendControl{};
+  ControlCallback m_controlCallback{};
 };
 
 }  // namespace ac
@@ -1,6 +1,5 @@
 #pragma once
 #include <Arduino.h>
-#include <set>
 
 namespace dudanov {
 namespace midea {
@@ -9,106 +8,175 @@ class FrameData;
 
 namespace ac {
 
+enum CapabilityID : uint16_t {
+  CAPABILITY_INDOOR_HUMIDITY = 0x0015,
+  CAPABILITY_SILKY_COOL = 0x0018,
+  CAPABILITY_SMART_EYE = 0x0030,
+  CAPABILITY_WIND_ON_ME = 0x0032,
+  CAPABILITY_WIND_OF_ME = 0x0033,
+  CAPABILITY_ACTIVE_CLEAN = 0x0039,
+  CAPABILITY_ONE_KEY_NO_WIND_ON_ME = 0x0042,
+  CAPABILITY_BREEZE_CONTROL = 0x0043,
+  CAPABILITY_FAN_SPEED_CONTROL = 0x0210,
+  CAPABILITY_PRESET_ECO = 0x0212,
+  CAPABILITY_PRESET_FREEZE_PROTECTION = 0x0213,
+  CAPABILITY_MODES = 0x0214,
+  CAPABILITY_SWING_MODES = 0x0215,
+  CAPABILITY_POWER = 0x0216,
+  CAPABILITY_NEST = 0x0217,
+  CAPABILITY_AUX_ELECTRIC_HEATING = 0x0219,
+  CAPABILITY_PRESET_TURBO = 0x021A,
+  CAPABILITY_HUMIDITY = 0x021F,
+  CAPABILITY_UNIT_CHANGEABLE = 0x0222,
+  CAPABILITY_LIGHT_CONTROL = 0x0224,
+  CAPABILITY_TEMPERATURES = 0x0225,
+  CAPABILITY_BUZZER = 0x022C,
+};
+
+/// Appliance capabilities. Trivially copyable: may be cached and compared cheaply.
 class Capabilities {
  public:
   // Read from frames
   bool read(const FrameData &data);
   // Dump capabilities
   void dump() const;
+  /// Appliance has reported capability, including unknown ones
+  bool has(CapabilityID id) const { return this->m_find(id) < this->m_num; }
+  /// First data byte of reported capability. 0 if it was not reported.
+  uint8_t raw(CapabilityID id) const;
+  /// Number of reported capabilities
+  uint8_t size() const { return this->m_num; }
+  /// Hash of reported capabilities
+  uint32_t fingerprint() const;
+  /// Maximum size of serialized capabilities: 22 bytes of header and checksum plus 3 bytes per capability
+  static const size_t SERIALIZED_SIZE = 22 + 3 * 32;
+  /// Serialize to versioned binary form with user `tag`. Returns number of written bytes or 0 if buffer is too small.
+  size_t serialize(uint8_t *data, size_t size, uint32_t tag) const;
+  /// Restore from binary form. Returns `false` if data is corrupted or has other version.
+  bool deserialize(const uint8_t *data, size_t size, uint32_t &tag);
+  bool operator==(const Capabilities &other) const;
+  bool operator!=(const Capabilities &other) const { return !(*this == other); }
 
   // Control humidity
-  bool autoSetHumidity() const { return this->m_autoSetHumidity; };
-  bool activeClean() const { return this->m_activeClean; };
-  bool breezeControl() const { return this->m_breezeControl; };
-  bool buzzer() const { return this->m_buzzer; }
-  bool decimals() const { return this->m_decimals; }
-  bool electricAuxHeating() const { return this->m_electricAuxHeating; }
-  bool fanSpeedControl() const { return this->m_fanSpeedControl; }
-  bool indoorHumidity() const { return this->m_indoorHumidity; }
+  bool autoSetHumidity() const { return this->m_get(AUTO_SET_HUMIDITY); };
+  bool activeClean() const { return this->m_get(ACTIVE_CLEAN); };
+  bool breezeControl() const { return this->m_get(BREEZE_CONTROL); };
+  bool buzzer() const { return this->m_get(BUZZER); }
+  bool decimals() const { return this->m_get(DECIMALS); }
+  bool electricAuxHeating() const { return this->m_get(ELECTRIC_AUX_HEATING); }
+  bool fanSpeedControl() const { return this->m_get(FAN_SPEED_CONTROL); }
+  bool indoorHumidity() const { return this->m_get(INDOOR_HUMIDITY); }
   // Control humidity
-  bool manualSetHumidity() const { return this->m_manualSetHumidity; }
-  bool nestCheck() const { return this->m_nestCheck; }
-  bool nestNeedChange() const { return this->m_nestNeedChange; }
-  bool oneKeyNoWindOnMe() const { return this->m_oneKeyNoWindOnMe; }
-  bool powerCal() const { return this->m_powerCal; }
-  bool powerCalSetting() const { return this->m_powerCalSetting; }
-  bool silkyCool() const { return this->m_silkyCool; }
+  bool manualSetHumidity() const { return this->m_get(MANUAL_SET_HUMIDITY); }
+  bool nestCheck() const { return this->m_get(NEST_CHECK); }
+  bool nestNeedChange() const { return this->m_get(NEST_NEED_CHANGE); }
+  bool oneKeyNoWindOnMe() const { return this->m_get(ONE_KEY_NO_WIND_ON_ME); }
+  bool powerCal() const { return this->m_get(POWER_CAL); }
+  bool powerCalSetting() const { return this->m_get(POWER_CAL_SETTING); }
+  bool silkyCool() const { return this->m_get(SILKY_COOL); }
   // Intelligent eye function
-  bool smartEye() const { return this->m_smartEye; }
+  bool smartEye() const { return this->m_get(SMART_EYE); }
   // Temperature unit can be changed between Celsius and Fahrenheit
-  bool unitChangeable() const { return this->m_unitChangeable; }
-  bool windOfMe() const { return this->m_windOfMe; }
-  bool windOnMe() const { return this->m_windOnMe; }
-  
+  bool unitChangeable() const { return this->m_get(UNIT_CHANGEABLE); }
+  bool windOfMe() const { return this->m_get(WIND_OF_ME); }
+  bool windOnMe() const { return this->m_get(WIND_ON_ME); }
+
   /* MODES */
 
-  bool supportAutoMode() const { return this->m_autoMode; }
-  bool supportCoolMode() const { return this->m_coolMode; }
-  bool supportHeatMode() const { return this->m_heatMode; }
-  bool supportDryMode() const { return this->m_dryMode; }
+  bool supportAutoMode() const { return this->m_get(AUTO_MODE); }
+  bool supportCoolMode() const { return this->m_get(COOL_MODE); }
+  bool supportHeatMode() const { return this->m_get(HEAT_MODE); }
+  bool supportDryMode() const { return this->m_get(DRY_MODE); }
 
   /* PRESETS */
 
-  bool supportFrostProtectionPreset() const { return this->m_frostProtectionMode; }
-  bool supportTurboPreset() const { return this->m_turboCool || this->m_turboHeat; }
-  bool supportEcoPreset() const { return this->m_ecoMode || this->m_specialEco; }
+  bool supportFrostProtectionPreset() const { return this->m_get(FROST_PROTECTION_MODE); }
+  bool supportTurboPreset() const { return this->m_get(TURBO_COOL) || this->m_get(TURBO_HEAT); }
+  bool supportEcoPreset() const { return this->m_get(ECO_MODE) || this->m_get(SPECIAL_ECO); }
 
   /* SWING MODES */
 
-  bool supportVerticalSwing() const { return this->m_updownFan; }
-  bool supportHorizontalSwing() const { return this->m_leftrightFan; }
-  bool supportBothSwing() const { return this->m_updownFan && this->m_leftrightFan; }
+  bool supportVerticalSwing() const { return this->m_get(UPDOWN_FAN); }
+  bool supportHorizontalSwing() const { return this->m_get(LEFTRIGHT_FAN); }
+  bool supportBothSwing() const { return this->m_get(UPDOWN_FAN) && this->m_get(LEFTRIGHT_FAN); }
 
   /* TEMPERATURES */
 
-  float maxTempAuto() const { return this->m_maxTempAuto; }
-  float maxTempCool() const { return this->m_maxTempCool; }
-  float maxTempHeat() const { return this->m_maxTempHeat; }
-  float minTempAuto() const { return this->m_minTempAuto; }
-  float minTempCool() const { return this->m_minTempCool; }
-  float minTempHeat() const { return this->m_minTempHeat; }
+  float maxTempAuto() const { return this->m_getTemp(MAX_TEMP_AUTO); }
+  float maxTempCool() const { return this->m_getTemp(MAX_TEMP_COOL); }
+  float maxTempHeat() const { return this->m_getTemp(MAX_TEMP_HEAT); }
+  float minTempAuto() const { return this->m_getTemp(MIN_TEMP_AUTO); }
+  float minTempCool() const { return this->m_getTemp(MIN_TEMP_COOL); }
+  float minTempHeat() const { return this->m_getTemp(MIN_TEMP_HEAT); }
 
   // Ability to turn LED display off
-  bool supportLightControl() const { return this->m_lightControl; }
+  bool supportLightControl() const { return this->m_get(LIGHT_CONTROL); }
 
  protected:
-  bool m_updownFan{false};
-  bool m_leftrightFan{false};
-  bool m_autoMode{false};
-  bool m_coolMode{false};
-  bool m_dryMode{false};
-  bool m_ecoMode{false};
-  bool m_specialEco{false};
-  bool m_frostProtectionMode{false};
-  bool m_heatMode{false};
-  bool m_turboCool{false};
-  bool m_turboHeat{false};
-  bool m_autoSetHumidity{false};
-  bool m_activeClean{false};
-  bool m_breezeControl{false};
-  bool m_buzzer{false};
-  bool m_decimals{false};
-  bool m_electricAuxHeating{false};
-  bool m_fanSpeedControl{true};
-  bool m_indoorHumidity{false};
-  bool m_lightControl{false};
-  bool m_manualSetHumidity{false};
-  float m_maxTempAuto{30};
-  float m_maxTempCool{30};
-  float m_maxTempHeat{30};
-  float m_minTempAuto{17};
-  float m_minTempCool{17};
-  float m_minTempHeat{17};
-  bool m_nestCheck{false};
-  bool m_nestNeedChange{false};
-  bool m_oneKeyNoWindOnMe{false};
-  bool m_powerCal{false};
-  bool m_powerCalSetting{false};
-  bool m_silkyCool{false};
-  bool m_smartEye{false};
-  bool m_unitChangeable{false};
-  bool m_windOfMe{false};
-  bool m_windOnMe{false};
+  friend class StateCodec;
+  enum Flag : uint8_t {
+    UPDOWN_FAN,
+    LEFTRIGHT_FAN,
+    AUTO_MODE,
+    COOL_MODE,
+    DRY_MODE,
+    ECO_MODE,
+    SPECIAL_ECO,
+    FROST_PROTECTION_MODE,
+    HEAT_MODE,
+    TURBO_COOL,
+    TURBO_HEAT,
+    AUTO_SET_HUMIDITY,
+    ACTIVE_CLEAN,
+    BREEZE_CONTROL,
+    BUZZER,
+    DECIMALS,
+    ELECTRIC_AUX_HEATING,
+    FAN_SPEED_CONTROL,
+    INDOOR_HUMIDITY,
+    LIGHT_CONTROL,
+    MANUAL_SET_HUMIDITY,
+    NEST_CHECK,
+    NEST_NEED_CHANGE,
+    ONE_KEY_NO_WIND_ON_ME,
+    POWER_CAL,
+    POWER_CAL_SETTING,
+    SILKY_COOL,
+    SMART_EYE,
+    UNIT_CHANGEABLE,
+    WIND_OF_ME,
+    WIND_ON_ME,
+    FLAG_NONE = 0xFF,
+  };
+  enum TempIndex : uint8_t {
+    MIN_TEMP_COOL,
+    MAX_TEMP_COOL,
+    MIN_TEMP_AUTO,
+    MAX_TEMP_AUTO,
+    MIN_TEMP_HEAT,
+    MAX_TEMP_HEAT,
+  };
+  // Rule of mapping capability value to flags
+  struct Rule;
+  static const Rule RULES[];
+  // Maximum number of stored capabilities
+  static const uint8_t MAX_CAPABILITIES = 32;
+  bool m_get(Flag flag) const { return this->m_flags & (1UL << flag); }
+  float m_getTemp(TempIndex idx) const { return static_cast<float>(this->m_temps[idx]) * 0.5F; }
+  // Index of capability in sorted table or `m_num` if not found
+  uint8_t m_find(uint16_t id) const;
+  void m_store(uint16_t id, uint8_t value);
+  void m_apply(uint16_t id, uint8_t value);
+  // Flags bitset
+  uint32_t m_flags{1UL << FAN_SPEED_CONTROL};
+  // Sorted IDs of reported capabilities
+  uint16_t m_ids[MAX_CAPABILITIES]{};
+  // First data bytes of reported capabilities
+  uint8_t m_values[MAX_CAPABILITIES]{};
+  // Temperature ranges in 0.5 °C
+  uint8_t m_temps[6]{34, 60, 34, 60, 34, 60};
+  // Number of reported capabilities
+  uint8_t m_num{};
 };
 
 }  // namespace ac
@@ -0,0 +1,61 @@
+#pragma once
+#include <Arduino.h>
+
+namespace dudanov {
+namespace midea {
+namespace ac {
+
+/// Energy accumulator. Integrates samples of appliance energy counter into hourly buckets of last 7 days.
+/// Counter delta is spread over time between samples, so buckets don't depend on polling moments.
+class EnergyMeter {
+ public:
+  /// Number of hourly buckets
+  static const uint8_t NUM_BUCKETS = 168;
+  /// Bucket duration, s
+  static const uint32_t BUCKET_TIME = 3600;
+  /// BCD counter of 0.1 kWh wraps at 99999.9 kWh
+  static const uint32_t COUNTER_MODULO = 1000000;
+  /// Size of serialized state: 3 bytes of header, 4 fields, buckets and checksum
+  static const size_t SERIALIZED_SIZE = 3 + 4 * 4 + 1 + 2 * NUM_BUCKETS + 4;
+
+  /// Add counter sample. `time`: seconds of any monotonic clock, `counter`: 0.1 kWh.
+  void addSample(uint32_t time, uint32_t counter);
+  /// Energy accumulated since first sample, Wh
+  uint32_t getTotal() const { return this->m_total; }
+  /// Energy of hourly bucket. `hoursAgo`: 0 - current hour. Wh.
+  uint16_t getHour(uint8_t hoursAgo) const;
+  /// Energy of last `hours` hourly buckets including current one, Wh
+  uint32_t getLastHours(uint8_t hours) const;
+  /// Start time of current bucket, s
+  uint32_t getBucketStart() const { return this->m_bucketStart; }
+  /// Export buckets from oldest to current. Returns number of written values.
+  uint8_t exportHours(uint16_t *data, uint8_t size) const;
+  /// Serialize to versioned binary form. Returns number of written bytes or 0 if buffer is too small.
+  size_t serialize(uint8_t *data, size_t size) const;
+  /// Restore from binary form. Returns `false` if data is corrupted or has other version.
+  bool deserialize(const uint8_t *data, size_t size);
+
+ protected:
+  // Advance current bucket to `time`. Returns `false` if clock has jumped back.
+  bool m_advance(uint32_t time);
+  // Spread `energy` over time interval ending in current bucket
+  void m_spread(uint32_t energy, uint32_t begin, uint32_t end);
+  uint16_t &m_bucket(uint8_t hoursAgo) { return this->m_buckets[(this->m_head + NUM_BUCKETS - hoursAgo) % NUM_BUCKETS]; }
+  void m_add(uint8_t hoursAgo, uint32_t energy);
+  // Hourly energy, Wh
+  uint16_t m_buckets[NUM_BUCKETS]{};
+  // Start time of current bucket
+  uint32_t m_bucketStart{};
+  // Last sample
+  uint32_t m_lastTime{};
+  uint32_t m_lastCounter{};
+  // Total energy, Wh
+  uint32_t m_total{};
+  // Index of current bucket
+  uint8_t m_head{};
+  bool m_hasSample{};
+};
+
+}  // namespace ac
+}  // namespace midea
+}  // namespace dudanov
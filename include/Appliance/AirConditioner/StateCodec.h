@@ -0,0 +1,74 @@
+#pragma once
+#include <Arduino.h>
+#include "Appliance/AirConditioner/AcState.h"
+#include "Appliance/AirConditioner/Capabilities.h"
+
+namespace dudanov {
+namespace midea {
+namespace ac {
+
+/// Type of encoded message: first byte
+enum MessageType : uint8_t {
+  /// Full state snapshot
+  MESSAGE_STATE = 'S',
+  /// Changed state fields against snapshot with `FIELD_BASE_SEQUENCE`
+  MESSAGE_DELTA = 'D',
+  MESSAGE_CAPABILITIES = 'C',
+};
+
+/// Stable field IDs of state messages. New fields get new IDs, IDs are never reused.
+enum StateField : uint8_t {
+  FIELD_SEQUENCE = 1,
+  FIELD_BASE_SEQUENCE = 2,
+  FIELD_MODE = 3,
+  FIELD_PRESET = 4,
+  FIELD_FAN_MODE = 5,
+  FIELD_SWING_MODE = 6,
+  /// Zigzag, 0.1 °C
+  FIELD_TARGET_TEMP = 7,
+  /// Zigzag, 0.1 °C
+  FIELD_INDOOR_TEMP = 8,
+  /// Zigzag, 0.1 °C
+  FIELD_OUTDOOR_TEMP = 9,
+  FIELD_HUMIDITY_SETPOINT = 10,
+  /// 0.1 kWh
+  FIELD_POWER_USAGE = 11,
+};
+
+/// Stable field IDs of capabilities messages
+enum CapabilitiesField : uint8_t {
+  FIELD_FLAGS = 1,
+  /// Six temperature limits in order: min cool, max cool, min auto, max auto, min heat, max heat. 0.5 °C.
+  FIELD_TEMP_FIRST = 2,
+  /// Reported capability: `id << 8 | value`. Repeated.
+  FIELD_CAPABILITY = 8,
+};
+
+/// Compact binary encoding of state snapshot and capabilities for bridges. Message is type byte followed by
+/// fields: ID byte and varint value. Every value is varint, so decoders skip fields with unknown IDs.
+/// Encoders write to caller buffer and never allocate.
+class StateCodec {
+ public:
+  /// Maximum size of state or delta message
+  static const size_t MAX_STATE_SIZE = 1 + 2 * (1 + 3) + 5 * (1 + 2) + 3 * (1 + 3) + (1 + 5);
+  /// Maximum size of capabilities message
+  static const size_t MAX_CAPABILITIES_SIZE = 1 + (1 + 5) + 6 * (1 + 2) + 32 * (1 + 4);
+  /// Encode full snapshot. Returns number of written bytes or 0 if buffer is too small.
+  static size_t encode(const AcState &state, uint8_t *data, size_t size);
+  /// Encode fields of `state` changed against `prev`. Returns number of written bytes or 0 if buffer is too small.
+  static size_t encodeDelta(const AcState &state, const AcState &prev, uint8_t *data, size_t size);
+  /// Encode capabilities. Returns number of written bytes or 0 if buffer is too small.
+  static size_t encode(const Capabilities &capabilities, uint8_t *data, size_t size);
+  /// Apply state or delta message to `state` and set its `changeMask`. Returns `false` if message is corrupted
+  /// or delta has other base sequence: full snapshot is needed then.
+  static bool decode(const uint8_t *data, size_t size, AcState &state);
+  /// Decode capabilities message. Returns `false` if message is corrupted.
+  static bool decode(const uint8_t *data, size_t size, Capabilities &capabilities);
+
+ protected:
+  static size_t m_encodeState(const AcState &state, const AcState *prev, uint8_t *data, size_t size);
+};
+
+}  // namespace ac
+}  // namespace midea
+}  // namespace dudanov
@@ -1,5 +1,6 @@
 #pragma once
 #include <Arduino.h>
+#include <cmath>
 #include "Frame/FrameData.h"
 
 namespace dudanov {
@@ -64,6 +65,40 @@ enum Preset : uint8_t {
   PRESET_FREEZE_PROTECTION,
 };
 
+struct AcState;
+
+/// Layout of status payload. Reading fields are from 0xC0 response, writing ones are for 0x40 request.
+struct StatusLayout {
+  using Power = Field<1, 1>;
+  using BeeperEnable = Field<1, 2>;
+  using Beeper = Field<1, 64>;
+  using Mode = Field<2, 7, 5>;
+  using TargetTemp = Field<2, 15>;
+  using TargetTempHalf = Field<2, 16>;
+  using TargetTempSet = Field<2, 31>;
+  using FanMode = Field<3>;
+  using SwingMode = Field<7, 15>;
+  using SwingModeSet = Field<7>;
+  using Turbo = Field<8, 32>;
+  using Eco = Field<9, 16>;
+  using EcoSet = Field<9, 128>;
+  using Sleep = Field<10, 1>;
+  using TurboAlt = Field<10, 2>;
+  using Fahrenheits = Field<10, 4>;
+  using IndoorTemp = Field<11>;
+  using OutdoorTemp = Field<12>;
+  using TargetTempNew = Field<13, 31>;
+  using IndoorTempDecimal = Field<15, 15>;
+  using OutdoorTempDecimal = Field<15, 15, 4>;
+  using TargetTempNewSet = Field<18, 31>;
+  using HumiditySetpoint = Field<19, 127>;
+  using FreezeProtection = Field<21, 128>;
+  /// Minimal size of payload containing all reading fields
+  static constexpr uint8_t SIZE = fieldsSize<Power, Mode, TargetTemp, TargetTempHalf, FanMode, SwingMode, Turbo, Eco,
+                                              Sleep, TurboAlt, Fahrenheits, IndoorTemp, OutdoorTemp, TargetTempNew,
+                                              IndoorTempDecimal, OutdoorTempDecimal, HumiditySetpoint, FreezeProtection>();
+};
+
 class StatusData : public FrameData {
  public:
   StatusData() : FrameData({0x40, 0x00, 0x00, 0x00, 0x7F, 0x7F, 0x00, 0x00, 0x00, 0x00,
@@ -72,68 +107,86 @@ class StatusData : public FrameData {
   StatusData(const FrameData &data) : FrameData(data) {}
 
   /// Copy status from another StatusData
-  void copyStatus(const StatusData &p) { memcpy(this->m_data.data() + 1, p.data() + 1, 10); }
+  void copyStatus(const StatusData &p) { this->copyStatus(p.data()); }
+  /// Copy status from 0xC0 payload of at least 11 bytes
+  void copyStatus(const uint8_t *data) { memcpy(this->m_data.data() + 1, data + 1, 10); }
 
   /* TARGET TEMPERATURE */
-  float getTargetTemp() const;
-  void setTargetTemp(float temp);
+  /// Target temperature, 0.1 °C
+  int16_t getTargetTempTenths() const;
+  void setTargetTempTenths(int16_t temp);
+  float getTargetTemp() const { return static_cast<float>(this->getTargetTempTenths()) / 10.0F; }
+  void setTargetTemp(float temp) { this->setTargetTempTenths(static_cast<int16_t>(lroundf(temp * 10.0F))); }
 
   /* MODE */
-  Mode getRawMode() const { return static_cast<Mode>(this->m_getValue(2, 7, 5)); }
+  Mode getRawMode() const { return static_cast<Mode>(this->m_get<StatusLayout::Mode>()); }
   Mode getMode() const;
   void setMode(Mode mode);
 
   /* FAN SPEED */
   FanMode getFanMode() const;
-  void setFanMode(FanMode mode) { this->m_setValue(3, mode); };
+  void setFanMode(FanMode mode) { this->m_set<StatusLayout::FanMode>(mode); };
 
   /* SWING MODE */
-  SwingMode getSwingMode() const { return static_cast<SwingMode>(this->m_getValue(7, 15)); }
-  void setSwingMode(SwingMode mode) { this->m_setValue(7, 0x30 | mode); }
+  SwingMode getSwingMode() const { return static_cast<SwingMode>(this->m_get<StatusLayout::SwingMode>()); }
+  void setSwingMode(SwingMode mode) { this->m_set<StatusLayout::SwingModeSet>(0x30 | mode); }
 
   /* INDOOR TEMPERATURE */
-  float getIndoorTemp() const;
+  /// Indoor temperature, 0.1 °C
+  int16_t getIndoorTempTenths() const;
+  float getIndoorTemp() const { return static_cast<float>(this->getIndoorTempTenths()) / 10.0F; }
 
   /* OUTDOOR TEMPERATURE */
-  float getOutdoorTemp() const;
+  /// Outdoor temperature, 0.1 °C
+  int16_t getOutdoorTempTenths() const;
+  float getOutdoorTemp() const { return static_cast<float>(this->getOutdoorTempTenths()) / 10.0F; }
 
   /* HUMIDITY SETPOINT */
-  float getHumiditySetpoint() const;
+  uint8_t getHumiditySetpoint() const { return this->m_get<StatusLayout::HumiditySetpoint>(); }
 
   /* PRESET */
   Preset getPreset() const;
   void setPreset(Preset preset);
 
   /* POWER USAGE */
-  float getPowerUsage() const;
+  /// Total power usage, 0.1 kWh
+  uint32_t getPowerUsageTenths() const { return StatusData::decodePowerUsage(this->m_data.data()); }
+  /// Decode power usage from 0xC1 payload of at least 19 bytes, 0.1 kWh
+  static uint32_t decodePowerUsage(const uint8_t *data);
+  float getPowerUsage() const { return static_cast<float>(this->getPowerUsageTenths()) / 10.0F; }
 
   void setBeeper(bool state) {
-    this->m_setMask(1, true, 2);
-    this->m_setMask(1, state, 64);
+    this->m_setFlag<StatusLayout::BeeperEnable>(true);
+    this->m_setFlag<StatusLayout::Beeper>(state);
   }
 
-  bool isFahrenheits() const { return this->m_getValue(10, 4); }
-  void setFahrenheits(bool state) { this->m_setMask(10, state, 4); }
+  bool isFahrenheits() const { return this->m_get<StatusLayout::Fahrenheits>(); }
+  void setFahrenheits(bool state) { this->m_setFlag<StatusLayout::Fahrenheits>(state); }
+
+  /// Decode all status fields to `state` in single pass over payload
+  void decodeAll(AcState &state) const { StatusData::decodeAll(this->m_data.data(), this->m_data.size(), state); }
+  /// Decode all status fields of 0xC0 payload in place
+  static void decodeAll(const uint8_t *data, uint8_t size, AcState &state);
 
  protected:
   /* POWER */
-  bool m_getPower() const { return this->m_getValue(1, 1); }
-  void m_setPower(bool state) { this->m_setMask(1, state, 1); }
+  bool m_getPower() const { return this->m_get<StatusLayout::Power>(); }
+  void m_setPower(bool state) { this->m_setFlag<StatusLayout::Power>(state); }
   /* ECO MODE */
-  bool m_getEco() const { return this->m_getValue(9, 16); }
-  void m_setEco(bool state) { this->m_setMask(9, state, 128); }
+  bool m_getEco() const { return this->m_get<StatusLayout::Eco>(); }
+  void m_setEco(bool state) { this->m_setFlag<StatusLayout::EcoSet>(state); }
   /* TURBO MODE */
-  bool m_getTurbo() const { return this->m_getValue(8, 32) || this->m_getValue(10, 2); }
+  bool m_getTurbo() const { return this->m_get<StatusLayout::Turbo>() || this->m_get<StatusLayout::TurboAlt>(); }
   void m_setTurbo(bool state) {
-    this->m_setMask(8, state, 32);
-    this->m_setMask(10, state, 2);
+    this->m_setFlag<StatusLayout::Turbo>(state);
+    this->m_setFlag<StatusLayout::TurboAlt>(state);
   }
   /* FREEZE PROTECTION */
-  bool m_getFreezeProtection() const { return this->m_getValue(21, 128); }
-  void m_setFreezeProtection(bool state) { this->m_setMask(21, state, 128); }
+  bool m_getFreezeProtection() const { return this->m_get<StatusLayout::FreezeProtection>(); }
+  void m_setFreezeProtection(bool state) { this->m_setFlag<StatusLayout::FreezeProtection>(state); }
   /* SLEEP MODE */
-  bool m_getSleep() const { return this->m_getValue(10, 1); }
-  void m_setSleep(bool state) { this->m_setMask(10, state, 1); }
+  bool m_getSleep() const { return this->m_get<StatusLayout::Sleep>(); }
+  void m_setSleep(bool state) { this->m_setFlag<StatusLayout::Sleep>(state); }
 };
 
 
@@ -141,14 +194,20 @@ class QueryStateData : public FrameData {
  public:
   QueryStateData() : FrameData({0x41, 0x81, 0x00, 0xFF, 0x03, 0xFF, 0x00, 0x02, 0x00, 0x00,
                                 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                                0x03, FrameData::m_getID()}) { this->appendCRC(); }
+                                0x03, FrameData::m_getID()}) {
+    this->m_hasID = true;
+    this->appendCRC();
+  }
 };
 
 class QueryPowerData : public FrameData {
  public:
   QueryPowerData() : FrameData({0x41, 0x21, 0x01, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
                                 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                                0x00, 0x04, FrameData::m_getID()}) { this->appendCRC(); }
+                                0x00, 0x04, FrameData::m_getID()}) {
+    this->m_hasID = true;
+    this->appendCRC();
+  }
 };
 
 class DisplayToggleData : public FrameData {
@@ -0,0 +1,97 @@
+#pragma once
+#include <Arduino.h>
+#include "Appliance/AirConditioner/AcState.h"
+
+namespace dudanov {
+namespace midea {
+namespace ac {
+
+/// Point of temperatures and mode history
+struct SeriesPoint {
+  /// Time, s
+  uint32_t time;
+  /// Temperatures, 0.1 °C
+  int16_t indoorTemp;
+  int16_t outdoorTemp;
+  int16_t targetTemp;
+  Mode mode;
+};
+
+/// Compressed series of points in fixed buffer. Each point is stored as delta against previous one: byte of changed
+/// values flags, varint time delta, zigzag varints of changed temperatures and new mode. When buffer is full, oldest
+/// points are folded into base point.
+class SeriesBuffer {
+ public:
+  /// Buffer size, bytes
+  static const uint16_t CAPACITY = 512;
+  /// Size of block header: magic, version, tier, interval, number of points, base point and data length
+  static const size_t HEADER_SIZE = 2 + 1 + 1 + 2 + 2 + 11 + 2;
+  void add(const SeriesPoint &point);
+  void clear() { this->m_num = this->m_length = 0; }
+  /// Number of points
+  uint16_t size() const { return this->m_num; }
+  /// Oldest point
+  const SeriesPoint &first() const { return this->m_base; }
+  /// Newest point
+  const SeriesPoint &last() const { return this->m_last; }
+  /// Call `fn(const SeriesPoint &)` for points from oldest to newest
+  template<typename Fn> void forEach(Fn fn) const {
+    if (!this->m_num)
+      return;
+    SeriesPoint point = this->m_base;
+    fn(point);
+    const uint8_t *const end = this->m_data + this->m_length;
+    for (const uint8_t *it = this->m_data; it < end && (it = decode(it, end, point)) != nullptr;)
+      fn(point);
+  }
+  /// Size of exported block, bytes
+  size_t blockSize() const { return HEADER_SIZE + this->m_length; }
+  /// Write exported block. Returns number of written bytes.
+  size_t write(Print &out, uint8_t tier, uint16_t interval) const;
+  /// Decode delta at `it` to `point`. Returns pointer past delta or `nullptr` if data is corrupted.
+  static const uint8_t *decode(const uint8_t *it, const uint8_t *end, SeriesPoint &point);
+
+ protected:
+  // Encode delta of `point` against `prev` to `it`. Returns pointer past delta.
+  static uint8_t *m_encode(uint8_t *it, const SeriesPoint &prev, const SeriesPoint &point);
+  // Fold oldest points into base point to free at least `size` bytes
+  void m_evict(uint16_t size);
+  SeriesPoint m_base{};
+  SeriesPoint m_last{};
+  uint16_t m_num{};
+  uint16_t m_length{};
+  uint8_t m_data[CAPACITY];
+};
+
+/// Fixed-memory history of temperatures and mode with downsampling tiers:
+/// 0 - changes with minimal interval of 10 s, 1 - averages of 1 min, 2 - averages of 15 min.
+class TimeSeries {
+ public:
+  static const uint8_t NUM_TIERS = 3;
+  /// Add appliance state sample at `time`, s
+  void add(uint32_t time, const AcState &state);
+  const SeriesBuffer &getTier(uint8_t tier) const { return this->m_tiers[tier]; }
+  /// Interval of tier points, s
+  static uint16_t getInterval(uint8_t tier);
+  /// Size of exported blocks of all tiers, bytes
+  size_t exportSize() const;
+  /// Write blocks of all tiers. Returns number of written bytes.
+  size_t write(Print &out) const;
+
+ protected:
+  // Averaging window of tier
+  struct Window {
+    uint32_t start;
+    int32_t indoorTemp;
+    int32_t outdoorTemp;
+    int32_t targetTemp;
+    uint16_t num;
+    Mode mode;
+  };
+  SeriesBuffer m_tiers[NUM_TIERS];
+  Window m_windows[NUM_TIERS]{};
+};
+
+}  // namespace ac
+}  // namespace midea
+}  // namespace dudanov
@@ -0,0 +1,80 @@
+#pragma once
+#include <Arduino.h>
+#include <type_traits>
+#include "Appliance/AirToWater/StatusData.h"
+
+namespace dudanov {
+namespace midea {
+namespace a2w {
+
+/// Bits of `A2wState::changeMask`
+enum StateChange : uint16_t {
+  CHANGE_ZONE1 = 1 << 0,
+  CHANGE_ZONE2 = 1 << 1,
+  CHANGE_MODE = 1 << 2,
+  CHANGE_DHW = 1 << 3,
+  CHANGE_DHW_TEMP = 1 << 4,
+  CHANGE_ROOM_TARGET_TEMP = 1 << 5,
+  CHANGE_OUTDOOR_TEMP = 1 << 6,
+  CHANGE_WATER_TEMP = 1 << 7,
+  CHANGE_COMPRESSOR = 1 << 8,
+  CHANGE_ENERGY = 1 << 9,
+  CHANGE_ERROR = 1 << 10,
+};
+
+/// Heating/cooling zone
+struct ZoneState {
+  bool power{};
+  /// Target temperature follows weather curve
+  bool curve{};
+  /// Target water temperature, °C
+  uint8_t targetTemp{};
+  uint8_t reserved{};
+  bool operator!=(const ZoneState &other) const {
+    return this->power != other.power || this->curve != other.curve || this->targetTemp != other.targetTemp;
+  }
+};
+
+/// Heat pump state snapshot. Plain data without padding, like `ac::AcState`.
+struct A2wState {
+  static const uint8_t MAX_ZONES = 2;
+  /// Time of last update, ms
+  uint32_t timestamp{};
+  /// Total consumed energy, kWh
+  uint32_t energyConsumed{};
+  /// Total produced heat energy, kWh
+  uint32_t energyProduced{};
+  /// Sequence number. Incremented on every change.
+  uint16_t sequence{};
+  /// `StateChange` bits changed by last update
+  uint16_t changeMask{};
+  ZoneState zones[MAX_ZONES]{};
+  /// Room target temperature, 0.5 °C
+  uint8_t roomTargetTemp{};
+  Mode mode{Mode::MODE_HEAT};
+  bool dhwPower{};
+  /// Domestic hot water target temperature, °C
+  uint8_t dhwTargetTemp{};
+  /// Domestic hot water tank temperature, °C
+  uint8_t dhwTemp{};
+  /// Outdoor temperature, °C
+  int8_t outdoorTemp{};
+  /// Water flow temperatures, °C
+  int8_t waterInTemp{};
+  int8_t waterOutTemp{};
+  /// Compressor frequency, Hz
+  uint8_t compressorFrequency{};
+  uint8_t errorCode{};
+  uint8_t reserved[2]{};
+
+  float getRoomTargetTemp() const { return static_cast<float>(this->roomTargetTemp) * 0.5F; }
+  /// Mask of `StateChange` bits which differ from `other`. Service fields are not compared.
+  uint16_t diff(const A2wState &other) const;
+};
+
+static_assert(std::is_trivially_copyable<A2wState>::value, "A2wState must be trivially copyable.");
+static_assert(sizeof(A2wState) == 36, "A2wState must have no padding.");
+
+}  // namespace a2w
+}  // namespace midea
+}  // namespace dudanov
@@ -0,0 +1,72 @@
+#pragma once
+#include <Arduino.h>
+#include "Appliance/Appliance.h"
+#include "Appliance/AirToWater/A2wState.h"
+#include "Appliance/AirToWater/StatusData.h"
+#include "Helpers/Helpers.h"
+
+namespace dudanov {
+namespace midea {
+namespace a2w {
+
+// Heat pump control command
+struct Control {
+  Optional<bool> zonePower[A2wState::MAX_ZONES]{};
+  /// Target water temperature of zones, °C
+  Optional<uint8_t> zoneTargetTemp[A2wState::MAX_ZONES]{};
+  Optional<Mode> mode{};
+  Optional<bool> dhwPower{};
+  /// Domestic hot water target temperature, °C
+  Optional<uint8_t> dhwTargetTemp{};
+};
+
+/// Periodic sub-queries: indexes of descriptor queries
+enum SubQuery : uint8_t {
+  /// Zones, DHW and setpoints
+  QUERY_BASIC,
+  /// Water flow temperatures and compressor
+  QUERY_UNIT,
+};
+
+/// Typed state observer. Receives new state snapshot.
+using StateObserver = Delegate<void(const A2wState &)>;
+
+/// Heat pump descriptor. Bodies are decoded in place by `StatusView`. Energy body is only reported.
+/// Zone 2 is always decoded, `AirToWater` discards it in single zone installations.
+struct A2wDescriptor {
+  static constexpr ApplianceType TYPE = AIR2WATER;
+  using State = A2wState;
+  static FrameData queryBasic() { return QueryData{BODY_BASIC}; }
+  static FrameData queryUnit() { return QueryData{BODY_UNIT}; }
+  static bool decode(const uint8_t *data, uint8_t size, A2wState &state) {
+    return StatusView(data, size).decode(state);
+  }
+  static constexpr QuerySpec<A2wState> QUERIES[] = {
+    {queryBasic, BODY_BASIC, decode, 0},
+    {queryUnit, BODY_UNIT, decode, 10000},
+    {nullptr, BODY_ENERGY, decode, POLL_DISABLED},
+  };
+};
+
+/// Sub-queries are polled by `setPollInterval(SubQuery, ms)`: `QUERY_BASIC` on every idle period and
+/// `QUERY_UNIT` every 10 s by default. Response or report of the same body restarts interval.
+class AirToWater : public Appliance<A2wDescriptor> {
+ public:
+  void control(const Control &control);
+  /// Number of installed zones: 1 or 2. Zone 2 is not decoded in single zone installations. Default: 1.
+  void setNumZones(uint8_t num) { this->m_numZones = (num > 1) ? 2 : 1; }
+  Mode getMode() const { return this->m_state.mode; }
+  /// State of zone: 0 or 1. Zones not installed read as powered off.
+  const ZoneState &getZone(uint8_t zone) const;
+  bool getDhwPower() const { return this->m_state.dhwPower; }
+  uint8_t getDhwTemp() const { return this->m_state.dhwTemp; }
+  int8_t getOutdoorTemp() const { return this->m_state.outdoorTemp; }
+ protected:
+  void m_onDecoded(uint8_t idx, const uint8_t *data, uint8_t size, A2wState &state) override;
+  uint8_t m_numZones{1};
+  bool m_sendControl{};
+};
+
+}  // namespace a2w
+}  // namespace midea
+}  // namespace dudanov
@@ -0,0 +1,102 @@
+#pragma once
+#include <Arduino.h>
+#include "Frame/FrameData.h"
+
+namespace dudanov {
+namespace midea {
+namespace a2w {
+
+/// Enum for all operating modes of heat pump
+enum Mode : uint8_t {
+  MODE_AUTO = 1,
+  MODE_COOL = 2,
+  MODE_HEAT = 3,
+};
+
+/// Type of 0xC3 message body: first payload byte
+enum BodyType : uint8_t {
+  /// Zones, DHW and setpoints. Answer to query and control.
+  BODY_BASIC = 0x01,
+  /// Unsolicited report of energy counters and outdoor temperature
+  BODY_ENERGY = 0x04,
+  /// Unit parameters: water flow temperatures and compressor
+  BODY_UNIT = 0x10,
+};
+
+struct A2wState;
+
+/// Layout of `BODY_BASIC` payload
+struct BasicLayout {
+  using Zone1Power = Field<1, 1>;
+  using Zone2Power = Field<1, 2>;
+  using DhwPower = Field<1, 4>;
+  using Zone1Curve = Field<1, 8>;
+  using Zone2Curve = Field<1, 16>;
+  using Mode = Field<4>;
+  using Zone1TargetTemp = Field<6>;
+  using Zone2TargetTemp = Field<7>;
+  using DhwTargetTemp = Field<8>;
+  // 0.5 °C
+  using RoomTargetTemp = Field<9>;
+  using DhwTemp = Field<22>;
+  using ErrorCode = Field<23>;
+  static constexpr uint8_t SIZE = fieldsSize<Zone1Power, Zone2Power, DhwPower, Zone1Curve, Zone2Curve, Mode,
+                                              Zone1TargetTemp, Zone2TargetTemp, DhwTargetTemp, RoomTargetTemp,
+                                              DhwTemp, ErrorCode>();
+};
+
+/// Layout of `BODY_ENERGY` payload. Counters are big-endian 32-bit kWh.
+struct EnergyLayout {
+  static constexpr uint8_t CONSUMED = 2;
+  static constexpr uint8_t PRODUCED = 6;
+  // Signed °C
+  using OutdoorTemp = Field<10>;
+  static constexpr uint8_t SIZE = fieldsSize<OutdoorTemp>();
+};
+
+/// Layout of `BODY_UNIT` payload. Temperatures are signed °C.
+struct UnitLayout {
+  using CompressorFrequency = Field<2>;
+  using WaterInTemp = Field<7>;
+  using WaterOutTemp = Field<8>;
+  static constexpr uint8_t SIZE = fieldsSize<CompressorFrequency, WaterInTemp, WaterOutTemp>();
+};
+
+/// Zero-copy view of 0xC3 payload. Fields are read in place from receive buffer.
+class StatusView {
+ public:
+  StatusView(const uint8_t *data, uint8_t size) : m_data(data), m_size(size) {}
+  explicit StatusView(const FrameData &data) : StatusView(data.data(), data.size()) {}
+  uint8_t getBodyType() const { return this->m_size ? this->m_data[0] : 0; }
+  /// Decode fields of known body to `state`. Both zones are decoded, unknown mode keeps previous one.
+  /// Returns `false` if body is unknown or too short.
+  bool decode(A2wState &state) const;
+
+ protected:
+  const uint8_t *m_data;
+  uint8_t m_size;
+};
+
+/// Sub-query of one body type
+class QueryData : public FrameData {
+ public:
+  explicit QueryData(BodyType type) : FrameData({type}) { this->appendCRC(); }
+};
+
+/// 0xC3 control body. Built from last `BODY_BASIC` status.
+class ControlData : public FrameData {
+ public:
+  ControlData() : FrameData({BODY_BASIC, 0x00, MODE_HEAT, 0x23, 0x23, 0x32, 0x2E, 0x00}) {}
+  void setZonePower(uint8_t zone, bool state) { this->m_setMask(1, state, 1 << zone); }
+  void setDhwPower(bool state) { this->m_setMask(1, state, 4); }
+  void setMode(Mode mode) { this->m_setValue(2, mode); }
+  void setZoneTargetTemp(uint8_t zone, uint8_t temp) { this->m_setValue(3 + zone, temp); }
+  void setDhwTargetTemp(uint8_t temp) { this->m_setValue(5, temp); }
+  /// Room target temperature, 0.5 °C
+  void setRoomTargetTemp(uint8_t temp) { this->m_setValue(6, temp); }
+  void setZoneCurve(uint8_t zone, bool state) { this->m_setMask(7, state, 1 << zone); }
+};
+
+}  // namespace a2w
+}  // namespace midea
+}  // namespace dudanov
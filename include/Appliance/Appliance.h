@@ -0,0 +1,220 @@
+#pragma once
+#include <Arduino.h>
+#include "Appliance/ApplianceBase.h"
+#include "Helpers/Log.h"
+
+namespace dudanov {
+namespace midea {
+
+/// Query of appliance descriptor
+template<typename State>
+struct QuerySpec {
+  /// Request payload factory. `nullptr` for unsolicited report which is never queried.
+  FrameData (*request)();
+  /// First byte of response payload
+  uint8_t responseID;
+  /// Decode response payload to state in place. Returns `false` if payload is not acceptable.
+  bool (*decode)(const uint8_t *data, uint8_t size, State &state);
+  /// Polling interval, ms. 0: on every idle period, `POLL_DISABLED`: only on startup.
+  uint32_t interval;
+};
+
+static const uint32_t POLL_DISABLED = UINT32_MAX;
+
+/// Appliance driven by descriptor `Desc`:
+///
+/// - `static constexpr ApplianceType TYPE`
+/// - `using State`: trivially copyable snapshot with `timestamp`, `sequence`, `changeMask` and `diff()`
+/// - `static constexpr QuerySpec<State> QUERIES[]`: first one is status query
+///
+/// Queries are sent on startup and polled on idle, most overdue first. Responses and unsolicited reports
+/// are decoded by their first payload byte and published as snapshot with change mask.
+/// Template is instantiated only for used descriptors, so unused drivers cost no flash.
+template<typename Desc>
+class Appliance : public ApplianceBase {
+ public:
+  using State = typename Desc::State;
+  static constexpr ApplianceType TYPE = Desc::TYPE;
+  static constexpr uint8_t NUM_QUERIES = sizeof(Desc::QUERIES) / sizeof(Desc::QUERIES[0]);
+  static_assert(NUM_QUERIES <= 8, "Too many queries in appliance descriptor.");
+  Appliance() : ApplianceBase(Desc::TYPE) {
+    for (uint8_t idx = 0; idx < NUM_QUERIES; ++idx)
+      this->m_intervals[idx] = Desc::QUERIES[idx].interval;
+  }
+  /// Consistent snapshot of all state properties
+  const State &getState() const { return this->m_state; }
+  /// Add typed state observer. Returns `false` if all observer slots are used.
+  bool addStateObserver(Delegate<void(const State &)> observer) { return this->m_stateObservers.add(observer); }
+  /// Pause polling of response for `ms` after its unsolicited report. Default: 0, polling is not paused.
+  void setReportHoldoff(uint32_t ms) { this->m_reportHoldoff = ms; }
+  /// Set polling interval of descriptor query `idx`, ms
+  void setPollInterval(uint8_t idx, uint32_t ms) {
+    if (idx < NUM_QUERIES)
+      this->m_intervals[idx] = ms;
+  }
+
+ protected:
+  void m_setup() override;
+  void m_onIdle() override;
+  uint32_t m_getIdleDelay() const override;
+  void m_query(uint8_t idx, RequestPriority priority = PRIORITY_POLL);
+  /// Response handler for requests answered by one of descriptor responses
+  ResponseStatus m_readResponse(FrameData data) { return this->m_read(data.data(), data.size()); }
+  // Unsolicited report handler. Decodes payload in place.
+  void m_onReport(const Frame &frame);
+  ResponseStatus m_read(const uint8_t *data, uint8_t size);
+  // Index of query with response `id` or `NUM_QUERIES`
+  uint8_t m_find(uint8_t id) const {
+    uint8_t idx = 0;
+    while (idx < NUM_QUERIES && Desc::QUERIES[idx].responseID != id)
+      ++idx;
+    return idx;
+  }
+  /// Called with decoded `state` of response `idx` before publishing. `m_state` is still previous.
+  virtual void m_onDecoded(uint8_t /*idx*/, const uint8_t * /*data*/, uint8_t /*size*/, State &/*state*/) {}
+  void m_publishState(State state);
+  DelegateList<void(const State &), 4> m_stateObservers;
+  State m_state{};
+  uint32_t m_intervals[NUM_QUERIES]{};
+  // Time of last request or response of query
+  TimerTick m_pollTimes[NUM_QUERIES]{};
+  // Time of last unsolicited report of query response
+  TimerTick m_reportTimes[NUM_QUERIES]{};
+  // Polling pause after unsolicited report
+  uint32_t m_reportHoldoff{};
+  // Bits of queries with received reports
+  uint8_t m_reportMask{};
+};
+
+template<typename Desc>
+void Appliance<Desc>::m_setup() {
+  this->m_addRoute(FrameType::DEVICE_REPORT, FrameHandler::bind<&Appliance::m_onReport>(this));
+  this->m_addRoute(FrameType::DEVICE_NOTIFY, FrameHandler::bind<&Appliance::m_onReport>(this));
+  // Startup sequence in order of descriptor
+  for (uint8_t idx = 0; idx < NUM_QUERIES; ++idx)
+    if (Desc::QUERIES[idx].request != nullptr)
+      this->m_query(idx, PRIORITY_QUERY);
+}
+
+template<typename Desc>
+void Appliance<Desc>::m_onIdle() {
+  // Most overdue query is sent. Others wait for next idle period.
+  const TimerTick ms = TimerManager::ms();
+  uint8_t next = NUM_QUERIES;
+  uint32_t maxOverdue = 0;
+  for (uint8_t idx = 0; idx < NUM_QUERIES; ++idx) {
+    const uint32_t interval = this->m_intervals[idx];
+    if (Desc::QUERIES[idx].request == nullptr || interval == POLL_DISABLED)
+      continue;
+    // Appliance reports this response itself, so polling is not needed for a while
+    if ((this->m_reportMask & (1 << idx)) && ms - this->m_reportTimes[idx] < this->m_reportHoldoff)
+      continue;
+    const uint32_t elapsed = ms - this->m_pollTimes[idx];
+    if (elapsed < interval)
+      continue;
+    const uint32_t overdue = elapsed - interval;
+    if (next == NUM_QUERIES || overdue > maxOverdue) {
+      next = idx;
+      maxOverdue = overdue;
+    }
+  }
+  if (next != NUM_QUERIES)
+    this->m_query(next);
+}
+
+template<typename Desc>
+uint32_t Appliance<Desc>::m_getIdleDelay() const {
+  // Time until first query becomes due, same rules as in `m_onIdle()`
+  const TimerTick ms = TimerManager::ms();
+  uint32_t delay = UINT32_MAX;
+  for (uint8_t idx = 0; idx < NUM_QUERIES; ++idx) {
+    const uint32_t interval = this->m_intervals[idx];
+    if (Desc::QUERIES[idx].request == nullptr || interval == POLL_DISABLED)
+      continue;
+    const uint32_t elapsed = ms - this->m_pollTimes[idx];
+    uint32_t wait = (elapsed < interval) ? interval - elapsed : 0;
+    const uint32_t sinceReport = ms - this->m_reportTimes[idx];
+    if ((this->m_reportMask & (1 << idx)) && sinceReport < this->m_reportHoldoff && this->m_reportHoldoff - sinceReport > wait)
+      wait = this->m_reportHoldoff - sinceReport;
+    if (wait < delay)
+      delay = wait;
+  }
+  return delay;
+}
+
+template<typename Desc>
+void Appliance<Desc>::m_query(uint8_t idx, RequestPriority priority) {
+  const QuerySpec<State> &spec = Desc::QUERIES[idx];
+  const uint32_t interval = this->m_intervals[idx];
+  this->m_pollTimes[idx] = TimerManager::ms();
+  LOG_D("Appliance", "Enqueuing a QUERY(0x%02X) request...", spec.responseID);
+  this->m_queueRequest(FrameType::DEVICE_QUERY, spec.request(),
+    // onData
+    [this, idx](FrameData data) -> ResponseStatus {
+      if (!data.size() || this->m_find(data.data()[0]) != idx)
+        return ResponseStatus::RESPONSE_WRONG;
+      return this->m_read(data.data(), data.size());
+    },
+    // Stale when next periodic request is due
+    nullptr, nullptr, priority, (interval != POLL_DISABLED) ? interval : 0
+  );
+}
+
+template<typename Desc>
+void Appliance<Desc>::m_onReport(const Frame &frame) {
+  const uint8_t *data = frame.getPayload();
+  const uint8_t size = frame.getPayloadSize();
+  if (this->m_read(data, size) != ResponseStatus::RESPONSE_OK)
+    return;
+  LOG_D("Appliance", "Unsolicited report 0x%02X received.", data[0]);
+  const uint8_t idx = this->m_find(data[0]);
+  this->m_reportTimes[idx] = TimerManager::ms();
+  this->m_reportMask |= 1 << idx;
+}
+
+template<typename Desc>
+ResponseStatus Appliance<Desc>::m_read(const uint8_t *data, uint8_t size) {
+  const uint8_t idx = size ? this->m_find(data[0]) : NUM_QUERIES;
+  if (idx == NUM_QUERIES)
+    return ResponseStatus::RESPONSE_WRONG;
+  State state = this->m_state;
+  if (!Desc::QUERIES[idx].decode(data, size, state))
+    return ResponseStatus::RESPONSE_WRONG;
+  // Fresh response makes its periodic query unnecessary for a while
+  this->m_pollTimes[idx] = TimerManager::ms();
+  this->m_onDecoded(idx, data, size, state);
+  this->m_publishState(state);
+  if (idx == 0)
+    this->m_setReady();
+  return ResponseStatus::RESPONSE_OK;
+}
+
+template<typename Desc>
+void Appliance<Desc>::m_publishState(State state) {
+  state.changeMask = state.diff(this->m_state);
+  state.timestamp = TimerManager::ms();
+  if (state.changeMask)
+    ++state.sequence;
+  // Whole snapshot is replaced at once, so observers never see partial update
+  this->m_state = state;
+  if (state.changeMask) {
+    this->sendUpdate();
+    this->m_stateObservers.call(this->m_state);
+  }
+}
+
+/// Compile-time list of appliance drivers with default constructors and static `TYPE`.
+/// Only listed drivers are instantiated and linked.
+template<typename... Drivers>
+struct ApplianceRegistry {
+  static constexpr bool supports(ApplianceType type) { return ((Drivers::TYPE == type) || ...); }
+  /// Create driver of `type`. Returns `nullptr` if type is not registered.
+  static ApplianceBase *create(ApplianceType type) {
+    ApplianceBase *appliance = nullptr;
+    ((appliance == nullptr && Drivers::TYPE == type && (appliance = new Drivers()) != nullptr), ...);
+    return appliance;
+  }
+};
+
+}  // namespace midea
+}  // namespace dudanov
@@ -1,10 +1,15 @@
 #pragma once
 #include <deque>
+#include <vector>
 #include <Arduino.h>
 #include "Frame/Frame.h"
 #include "Frame/FrameData.h"
+#include "Appliance/NetworkProvider.h"
+#include "Helpers/Delegate.h"
+#include "Helpers/RttEstimator.h"
 #include "Helpers/Timer.h"
 #include "Helpers/Logger.h"
+#include "Transport/Transport.h"
 
 namespace dudanov {
 namespace midea {
@@ -32,17 +37,77 @@ enum ResponseStatus : uint8_t {
   RESPONSE_WRONG,
 };
 
+/// Request priority classes. Requests of same class are sent in FIFO order.
+enum RequestPriority : uint8_t {
+  /// Appliance control by user
+  PRIORITY_CONTROL,
+  /// Interactive or startup queries
+  PRIORITY_QUERY,
+  /// Background polling
+  PRIORITY_POLL,
+  /// Network notifies
+  PRIORITY_NOTIFY,
+};
+
+/// Appliance link health
+enum LinkState : uint8_t {
+  /// Appliance answers requests
+  LINK_ONLINE,
+  /// Some of last requests have failed
+  LINK_DEGRADED,
+  /// Appliance doesn't answer. It is probed with exponential back-off, control requests fail immediately.
+  LINK_OFFLINE,
+};
+
 enum FrameType : uint8_t {
   DEVICE_CONTROL = 0x02,
   DEVICE_QUERY = 0x03,
+  /// Unsolicited status report
+  DEVICE_REPORT = 0x04,
+  /// Unsolicited status notification
+  DEVICE_NOTIFY = 0x05,
   GET_ELECTRONIC_ID = 0x07,
   NETWORK_NOTIFY = 0x0D,
   QUERY_NETWORK = 0x63,
 };
 
-using Handler = std::function<void()>;
-using ResponseHandler = std::function<ResponseStatus(FrameData)>;
+using Handler = Delegate<void()>;
+using ResponseHandler = Delegate<ResponseStatus(FrameData)>;
 using OnStateCallback = std::function<void()>;
+using OnReadyCallback = Delegate<void(uint32_t)>;
+using OnLinkStateCallback = Delegate<void(LinkState)>;
+using FrameHandler = Delegate<void(const Frame &)>;
+
+/// Link statistics, ms
+struct LinkStats {
+  /// Smoothed round-trip time
+  uint32_t srtt;
+  /// Round-trip time mean deviation
+  uint32_t rttvar;
+  uint32_t minRtt;
+  uint32_t maxRtt;
+  /// Current response timeout
+  uint32_t timeout;
+  /// Current minimal period between requests
+  uint32_t period;
+  /// Number of round-trip time samples
+  uint32_t numSamples;
+  /// Number of response timeouts
+  uint32_t numTimeouts;
+  /// Number of discarded late responses to retired requests
+  uint32_t numStale;
+};
+
+/// Heap used by appliance, bytes. Allocator overhead is not counted.
+struct MemoryUsage {
+  /// Queued and pending requests
+  size_t requests;
+  /// Frame buffers
+  size_t buffers;
+  /// Callback containers
+  size_t callbacks;
+  size_t total() const { return this->requests + this->buffers + this->callbacks; }
+};
 
 class ApplianceBase {
  public:
@@ -51,13 +116,20 @@ class ApplianceBase {
   void setup();
   /// Loop
   void loop();
+  /// Time until `loop()` has work to do without new input, ms. Event loops may sleep this long.
+  uint32_t getWakeDelay() const;
 
   /* ############################## */
   /* ### COMMUNICATION SETTINGS ### */
   /* ############################## */
 
   /// Set serial stream
-  void setStream(Stream *stream) { this->m_stream = stream; }
+  void setStream(Stream *stream) {
+    this->m_streamTransport.setStream(stream);
+    this->m_transport = &this->m_streamTransport;
+  }
+  /// Set transport other than `Stream`, e.g. `SocketTransport` on host
+  void setTransport(Transport *transport) { this->m_transport = transport; }
   /// Set minimal period between requests
   void setPeriod(uint32_t period) { this->m_period = period; }
   uint32_t getPeriod() const { return this->m_period; }
@@ -67,6 +139,46 @@ class ApplianceBase {
   /// Set number of request attempts
   void setNumAttempts(uint8_t numAttempts) { this->m_numAttempts = numAttempts; }
   uint8_t getNumAttempts() const { return this->m_numAttempts; }
+  /// Set maximum number of requests waiting for response at once (1..4). Default: 1, stop-and-wait.
+  /// Responses are matched to the oldest request accepting them, so appliance must answer in order
+  /// or echo message IDs. Requests of groups are never pipelined.
+  void setWindow(uint8_t window) { this->m_window = window < 1 ? 1 : window > MAX_WINDOW ? MAX_WINDOW : window; }
+  uint8_t getWindow() const { return this->m_window; }
+  /// Derive response timeout and period between requests from measured round-trip times.
+  /// Fixed timeout is used until first measurement, fixed period is used as upper limit.
+  void setAdaptiveTimeout(bool state) { this->m_isAdaptive = state; }
+  bool getAdaptiveTimeout() const { return this->m_isAdaptive; }
+  /// Set limits of adaptive response timeout
+  void setTimeoutLimits(uint32_t min, uint32_t max) {
+    this->m_minTimeout = min;
+    this->m_maxTimeout = max;
+  }
+  /// Set lower limit of adaptive period between requests
+  void setMinPeriod(uint32_t period) { this->m_minPeriod = period; }
+  /// Link statistics
+  LinkStats getLinkStats() const;
+  /// Set number of consecutive failed requests to consider appliance offline
+  void setOfflineThreshold(uint8_t numFailures) { this->m_offlineThreshold = numFailures; }
+  /// Set limits of probing interval of offline appliance. Interval is doubled after each failed probe.
+  void setProbeInterval(uint32_t min, uint32_t max) {
+    this->m_minProbeInterval = min;
+    this->m_maxProbeInterval = max;
+  }
+  LinkState getLinkState() const { return this->m_linkState; }
+  /// Set heap budget of queued requests, bytes. Request over budget evicts queued requests of lower priority
+  /// or fails with `onError` call. Default: 0, unlimited.
+  void setMemoryBudget(size_t bytes) { this->m_memoryBudget = bytes; }
+  /// Heap used by queued and pending requests, bytes
+  size_t getQueueMemory() const { return this->m_queueMemory; }
+  /// Current heap usage
+  virtual MemoryUsage getMemoryUsage() const;
+  /// Add listener for link state transitions
+  bool addOnLinkStateCallback(OnLinkStateCallback cb) { return this->m_linkCallbacks.add(cb); }
+  /// Set source of network status. Default: WiFi station on ESP targets, connected `StaticNetworkProvider` on others.
+  /// `nullptr` restores default. Cached status is refreshed at once if called after `setup()`.
+  void setNetworkProvider(NetworkProvider *provider);
+  /// Refresh cached network status from provider. Called automatically on provider revision change.
+  void updateNetwork();
   /// Set beeper feedback
   void setBeeper(bool value);
   /// Add listener for appliance state
@@ -75,29 +187,62 @@ class ApplianceBase {
     for (auto &cb : this->m_stateCallbacks)
       cb();
   }
+  /// Appliance type
+  ApplianceType getType() const { return this->m_appType; }
+  /// Appliance protocol version. Known after first received frame.
+  uint8_t getProtocol() const { return this->m_protocol; }
+  /// Set protocol version known in advance, e.g. by discovery
+  void setProtocol(uint8_t protocol) { this->m_protocol = protocol; }
+  /// Set appliance serial number. Its hash becomes part of appliance fingerprint.
+  void setSerialNumber(const uint8_t *data, uint8_t size) { this->m_serialHash = fnv1a(data, size); }
+  /// Hash of serial number. 0 if it is unknown.
+  uint32_t getSerialHash() const { return this->m_serialHash; }
+  /// Add listener for first appliance state after setup. Argument is time to first state, ms.
+  bool addOnReadyCallback(OnReadyCallback cb) { return this->m_readyCallbacks.add(cb); }
+  /// First appliance state is received
+  bool isReady() const { return this->m_isReady; }
+  /// Time from setup to first appliance state, ms
+  uint32_t getTimeToReady() const { return this->m_timeToReady; }
   AutoconfStatus getAutoconfStatus() const { return this->m_autoconfStatus; }
   void setAutoconf(bool state) { this->m_autoconfStatus = state ? AUTOCONF_PROGRESS : AUTOCONF_DISABLED; }
   static void setLogger(LoggerFn logger) { dudanov::setLogger(logger); }
 
  protected:
   std::vector<OnStateCallback> m_stateCallbacks;
+  DelegateList<void(uint32_t), 2> m_readyCallbacks;
+  DelegateList<void(LinkState), 2> m_linkCallbacks;
   // Timer manager
   TimerManager m_timerManager{};
   AutoconfStatus m_autoconfStatus{};
   // Beeper feedback flag
   bool m_beeper{};
 
-  void m_queueNotify(FrameType type, FrameData data) { this->m_queueRequest(type, std::move(data), nullptr); }
-  void m_queueRequest(FrameType type, FrameData data, ResponseHandler onData, Handler onSuccess = nullptr, Handler onError = nullptr);
-  void m_queueRequestPriority(FrameType type, FrameData data, ResponseHandler onData = nullptr, Handler onSuccess = nullptr, Handler onError = nullptr);
-  void m_sendFrame(FrameType type, const FrameData &data);
+  void m_queueNotify(FrameType type, FrameData data) {
+    this->m_queueRequest(type, std::move(data), nullptr, nullptr, nullptr, PRIORITY_NOTIFY);
+  }
+  /// Enqueue request. Request not sent within `timeToLive` ms (if not 0) is dropped with `onError` call.
+  void m_queueRequest(FrameType type, FrameData data, ResponseHandler onData, Handler onSuccess = nullptr,
+                      Handler onError = nullptr, RequestPriority priority = PRIORITY_QUERY, uint32_t timeToLive = 0);
+  /// Requests enqueued until `m_endGroup()` are sent in order without other requests between them. Group has
+  /// priority of its first request. If any request of group fails, rest of group is dropped with `onError` calls.
+  void m_beginGroup() { this->m_isGroup = true; }
+  void m_endGroup();
+  /// Returns `false` if transport has dropped frame
+  bool m_sendFrame(FrameType type, const FrameData &data);
+  bool m_writeFrame(const Frame &frame);
+  /// Route frames of `type` not matched to current request to `handler`. Returns `false` if routing table is full.
+  bool m_addRoute(FrameType type, FrameHandler handler);
+  /// Must be called by appliance on first received state
+  void m_setReady();
   // Setup for appliances
   virtual void m_setup() {}
   // Loop for appliances
   virtual void m_loop() {}
   /// Calling then ready for request
   virtual void m_onIdle() {}
-  /// Calling on receiving request
+  /// Time until `m_onIdle()` may have something to send, ms
+  virtual uint32_t m_getIdleDelay() const { return this->m_period; }
+  /// Calling on receiving frame without route
   virtual void m_onRequest(const Frame &frame) {}
  private:
   struct Request {
@@ -106,53 +251,199 @@ class ApplianceBase {
     Handler onSuccess;
     Handler onError;
     FrameType requestType;
+    RequestPriority priority;
+    // Continues group of previous request
+    bool chained;
+    // Group ID. 0: not in group.
+    uint16_t group;
+    uint32_t timeToLive;
+    TimerTick queueTime;
     ResponseStatus callHandler(const Frame &data);
+    bool isExpired() const { return this->timeToLive && TimerManager::ms() - this->queueTime >= this->timeToLive; }
+  };
+  struct Route {
+    FrameType type;
+    FrameHandler handler;
   };
+  static const uint8_t MAX_ROUTES = 4;
+  // Request waiting for response with its own timer
+  struct Slot {
+    Request *request;
+    Timer timer;
+    // Time of last sent frame
+    TimerTick requestTime;
+    // Sending order
+    uint32_t sequence;
+    uint8_t remainAttempts;
+    uint8_t numRetries;
+    // Responses with foreign message ID
+    uint8_t numMismatches;
+    // Current frame of request carries message ID
+    bool hasMessageID;
+  };
+  static const uint8_t MAX_WINDOW = 4;
   class FrameReceiver : public Frame {
   public:
-    bool read(Stream *stream);
+    bool read(Transport *transport);
     void clear() { this->m_data.clear(); }
   };
+  // Loop body: receiving, timers and sending
+  void m_process();
   void m_sendNetworkNotify(FrameType msg_type = NETWORK_NOTIFY);
   void m_handler(const Frame &frame);
-  bool m_isWaitForResponse() const { return this->m_request != nullptr; }
-  void m_resetAttempts() { this->m_remainAttempts = this->m_numAttempts; }
-  void m_destroyRequest();
-  void m_resetTimeout();
-  void m_sendRequest(Request *request) { this->m_sendFrame(request->requestType, request->request); }
+  // Offline appliance is probed with single attempt
+  void m_resetAttempts(Slot &slot) {
+    slot.remainAttempts = this->m_linkState == LINK_OFFLINE ? 1 : this->m_numAttempts;
+    slot.numRetries = 0;
+  }
+  // Send request and wait for response in free slot
+  void m_startRequest(Request *request);
+  // Returns `true` if response is accepted by request of slot
+  bool m_handleResponse(Slot &slot, const Frame &frame, const FrameData &data);
+  void m_onTimeout(Slot &slot);
+  // Busy slots in sending order. Returns their number.
+  uint8_t m_sortSlots(Slot **slots);
+  void m_setLinkState(LinkState state);
+  // Count failed request
+  void m_onLinkFailure();
+  // Fail queued control requests of offline appliance
+  void m_failControls();
+  void m_destroyRequest(Slot &slot);
+  static size_t m_requestMemory(const Request *request) { return sizeof(Request) + request->request.size(); }
+  void m_deleteRequest(Request *request) {
+    this->m_queueMemory -= m_requestMemory(request);
+    delete request;
+  }
+  // Evict queued requests of lower priority until `size` bytes fit in budget
+  bool m_reserve(size_t size, RequestPriority priority);
+  void m_pushRequest(Request *request) { this->m_queue.insert(this->m_findPosition(request->priority), request); }
+  std::deque<Request *>::iterator m_findPosition(RequestPriority priority);
+  Request *m_popRequest();
+  // Call `onError` and delete request with queued rest of its own group
+  void m_failRequest(Request *request);
+  void m_resetTimeout(Slot &slot);
+  // Response may be accepted by request of slot
+  bool m_isMatched(const Slot &slot, const FrameData &data) const;
+  // Response is late answer to retired request
+  bool m_isStale(const Frame &frame, const FrameData &data) const;
+  // Remember message ID of finished request
+  void m_retireRequest(const Request *request);
+  uint32_t m_getTimeout(uint8_t numRetries = 0) const;
+  uint32_t m_getPeriod() const;
+  bool m_sendRequest(Request *request) { return this->m_sendFrame(request->requestType, request->request); }
   // Frame receiver with dynamic buffer
   FrameReceiver m_receiver{};
   // Network status timer
   Timer m_networkTimer{};
-  // Waiting response timer
-  Timer m_responseTimer{};
+  NetworkProvider *m_networkProvider{};
+  // Ready network notify payload
+  NetworkNotifyData m_networkNotify{};
+  // Ready answer to QUERY_NETWORK
+  Frame m_networkReply{};
+  uint32_t m_networkRevision{};
   // Request period timer
   Timer m_periodTimer{};
+  // Frame routing table
+  Route m_routes[MAX_ROUTES]{};
+  uint8_t m_numRoutes{};
   // Queue requests
   std::deque<Request *> m_queue;
-  // Current request
-  Request *m_request{nullptr};
-  // Remaining request attempts
-  uint8_t m_remainAttempts{};
+  // Requests of group being enqueued
+  std::vector<Request *> m_group;
+  // ID of last group
+  uint16_t m_groupId{};
+  bool m_isGroup{};
+  // Requests waiting for response
+  Slot m_slots[MAX_WINDOW]{};
+  uint32_t m_sequence{};
+  uint8_t m_numInFlight{};
+  // Round-trip time estimator
+  RttEstimator m_rtt{};
+  // Time of last sent frame
+  TimerTick m_frameTime{};
+  // Number of response timeouts
+  uint32_t m_numTimeouts{};
+  // Heap used by requests
+  size_t m_queueMemory{};
+  // Heap budget of requests. 0: unlimited.
+  size_t m_memoryBudget{};
+
+  /* MESSAGE ID CORRELATION */
+
+  static const uint8_t NUM_RETIRED_IDS = 8;
+  static const uint8_t NUM_ECHO_TYPES = 4;
+  static const uint8_t NUM_ECHOES_TO_MATCH = 3;
+  // Echo of message ID is learned for each response type (first payload byte)
+  struct Echo {
+    uint8_t type;
+    // Consecutive responses with echoed message ID
+    uint8_t numEchoes;
+  };
+  // Returns `nullptr` if `type` is unknown and table is full
+  Echo *m_findEcho(uint8_t type, bool create);
+  const Echo *m_findEcho(uint8_t type) const { return const_cast<ApplianceBase *>(this)->m_findEcho(type, false); }
+  // Responses of this type are matched strictly
+  bool m_isStrict(const FrameData &data) const {
+    const Echo *echo = this->m_findEcho(data.data()[0]);
+    return echo != nullptr && echo->numEchoes >= NUM_ECHOES_TO_MATCH;
+  }
+  Echo m_echoes[NUM_ECHO_TYPES]{};
+  uint8_t m_numEchoTypes{};
+  // Message IDs of last finished requests
+  uint8_t m_retiredIDs[NUM_RETIRED_IDS]{};
+  uint8_t m_retiredPos{};
+  uint8_t m_numRetired{};
+  uint32_t m_numStale{};
+  // Link health
+  LinkState m_linkState{LINK_ONLINE};
+  // Consecutive failed requests
+  uint8_t m_numFailures{};
+  // Time of last probe of offline appliance
+  TimerTick m_probeTime{};
+  // Current probing interval
+  uint32_t m_probeInterval{};
   // Appliance type
   ApplianceType m_appType;
   // Appliance protocol
   uint8_t m_protocol{};
+  // Hash of appliance serial number
+  uint32_t m_serialHash{};
   // Period flag
   bool m_isBusy{};
+  // First state received flag
+  bool m_isReady{};
+  // Setup time
+  uint32_t m_setupTime{};
+  // Time to first state
+  uint32_t m_timeToReady{};
 
   /* ############################## */
   /* ### COMMUNICATION SETTINGS ### */
   /* ############################## */
 
-  // Stream serial interface
-  Stream *m_stream;
+  // Frames transport
+  Transport *m_transport{};
+  StreamTransport m_streamTransport{};
   // Minimal period between requests
   uint32_t m_period{1000};
   // Waiting response timeout
   uint32_t m_timeout{2000};
   // Number of request attempts
   uint8_t m_numAttempts{3};
+  // Maximum number of requests waiting for response
+  uint8_t m_window{1};
+  // Adaptive timeout and period flag
+  bool m_isAdaptive{};
+  // Adaptive timeout limits
+  uint32_t m_minTimeout{150};
+  uint32_t m_maxTimeout{5000};
+  // Adaptive period lower limit
+  uint32_t m_minPeriod{100};
+  // Consecutive failed requests to go offline
+  uint8_t m_offlineThreshold{3};
+  // Probing interval limits
+  uint32_t m_minProbeInterval{5000};
+  uint32_t m_maxProbeInterval{5 * 60 * 1000};
 };
 
 }  // namespace midea
@@ -0,0 +1,63 @@
+#pragma once
+#include <Arduino.h>
+#include "Appliance/Appliance.h"
+#include "Appliance/Dehumidifier/DhState.h"
+#include "Appliance/Dehumidifier/StatusData.h"
+#include "Helpers/Helpers.h"
+
+namespace dudanov {
+namespace midea {
+namespace dh {
+
+// Dehumidifier control command
+struct Control {
+  Optional<bool> power{};
+  Optional<Mode> mode{};
+  Optional<FanSpeed> fanSpeed{};
+  /// Humidity setpoint, %
+  Optional<uint8_t> targetHumidity{};
+  Optional<bool> ion{};
+};
+
+/// Typed state observer. Receives new state snapshot.
+using StateObserver = Delegate<void(const DhState &)>;
+
+/// Dehumidifier descriptor: status polled on every idle period
+struct DhDescriptor {
+  static constexpr ApplianceType TYPE = DEHUMIDIFIER;
+  using State = DhState;
+  static FrameData queryStatus() { return QueryStateData{}; }
+  static bool decodeStatus(const uint8_t *data, uint8_t size, DhState &state);
+  static constexpr QuerySpec<DhState> QUERIES[] = {
+    {queryStatus, 0xC8, decodeStatus, 0},
+  };
+};
+
+class Dehumidifier : public Appliance<DhDescriptor> {
+ public:
+  /// Humidity setpoint range, %
+  static const uint8_t MIN_TARGET_HUMIDITY = 35;
+  static const uint8_t MAX_TARGET_HUMIDITY = 85;
+  void control(const Control &control);
+  void setPowerState(bool state);
+  bool getPowerState() const { return this->m_state.power; }
+  void togglePowerState() { this->setPowerState(!this->m_state.power); }
+  Mode getMode() const { return this->m_state.mode; }
+  FanSpeed getFanSpeed() const { return this->m_state.fanSpeed; }
+  uint8_t getTargetHumidity() const { return this->m_state.targetHumidity; }
+  uint8_t getHumidity() const { return this->m_state.humidity; }
+  float getTemperature() const { return this->m_state.getTemperature(); }
+  uint8_t getTankLevel() const { return this->m_state.tankLevel; }
+  bool isTankFull() const { return this->m_state.isTankFull(); }
+  bool getIon() const { return this->m_state.ion; }
+  MemoryUsage getMemoryUsage() const override;
+ protected:
+  void m_onDecoded(uint8_t idx, const uint8_t *data, uint8_t size, DhState &state) override;
+  void m_setStatus(StatusData status);
+  StatusData m_status{};
+  bool m_sendControl{};
+};
+
+}  // namespace dh
+}  // namespace midea
+}  // namespace dudanov
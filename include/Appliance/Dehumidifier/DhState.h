@@ -0,0 +1,57 @@
+#pragma once
+#include <Arduino.h>
+#include <type_traits>
+#include "Appliance/Dehumidifier/StatusData.h"
+
+namespace dudanov {
+namespace midea {
+namespace dh {
+
+/// Bits of `DhState::changeMask`
+enum StateChange : uint16_t {
+  CHANGE_POWER = 1 << 0,
+  CHANGE_MODE = 1 << 1,
+  CHANGE_FAN_SPEED = 1 << 2,
+  CHANGE_TARGET_HUMIDITY = 1 << 3,
+  CHANGE_HUMIDITY = 1 << 4,
+  CHANGE_TEMPERATURE = 1 << 5,
+  CHANGE_TANK_LEVEL = 1 << 6,
+  CHANGE_ION = 1 << 7,
+  CHANGE_PUMP = 1 << 8,
+};
+
+/// Dehumidifier state snapshot. Plain data without padding, like `ac::AcState`.
+struct DhState {
+  /// Time of last update, ms
+  uint32_t timestamp{};
+  /// Sequence number. Incremented on every change.
+  uint16_t sequence{};
+  /// `StateChange` bits changed by last update
+  uint16_t changeMask{};
+  /// Ambient temperature, 0.1 °C
+  int16_t temperature{};
+  bool power{};
+  Mode mode{Mode::MODE_SETPOINT};
+  FanSpeed fanSpeed{FanSpeed::FAN_MEDIUM};
+  /// Humidity setpoint, %
+  uint8_t targetHumidity{};
+  /// Current humidity, %
+  uint8_t humidity{};
+  /// Water tank level, %
+  uint8_t tankLevel{};
+  bool ion{};
+  bool pump{};
+  uint8_t reserved[2]{};
+
+  float getTemperature() const { return static_cast<float>(this->temperature) / 10.0F; }
+  bool isTankFull() const { return this->tankLevel >= 100; }
+  /// Mask of `StateChange` bits which differ from `other`. Service fields are not compared.
+  uint16_t diff(const DhState &other) const;
+};
+
+static_assert(std::is_trivially_copyable<DhState>::value, "DhState must be trivially copyable.");
+static_assert(sizeof(DhState) == 20, "DhState must have no padding.");
+
+}  // namespace dh
+}  // namespace midea
+}  // namespace dudanov
@@ -0,0 +1,104 @@
+#pragma once
+#include <Arduino.h>
+#include "Frame/FrameData.h"
+
+namespace dudanov {
+namespace midea {
+namespace dh {
+
+/// Enum for all modes a Midea dehumidifier can be in.
+enum Mode : uint8_t {
+  /// Keeps humidity at setpoint
+  MODE_SETPOINT = 1,
+  /// Dehumidifies continuously
+  MODE_CONTINUOUS = 2,
+  /// Humidity setpoint is chosen by appliance
+  MODE_SMART = 3,
+  /// Clothes drying
+  MODE_DRYER = 4,
+};
+
+/// Enum for all speeds a Midea dehumidifier fan can be in
+enum FanSpeed : uint8_t {
+  /// The fan speed is set to Low
+  FAN_LOW = 40,
+  /// The fan speed is set to Medium
+  FAN_MEDIUM = 60,
+  /// The fan speed is set to High
+  FAN_HIGH = 80,
+};
+
+struct DhState;
+
+/// Layout of status payload. Reading fields are from 0xC8 response, writing ones are for 0x48 request.
+struct StatusLayout {
+  using Power = Field<1, 1>;
+  using BeeperEnable = Field<1, 2>;
+  using Beeper = Field<1, 64>;
+  using Mode = Field<2, 15>;
+  using FanSpeed = Field<3, 127>;
+  using TargetHumidity = Field<7, 127>;
+  using Pump = Field<9, 8>;
+  using Ion = Field<9, 64>;
+  using TankLevel = Field<10, 127>;
+  using Humidity = Field<16, 127>;
+  using Temperature = Field<17>;
+  /// Minimal size of payload containing all reading fields
+  static constexpr uint8_t SIZE = fieldsSize<Power, Mode, FanSpeed, TargetHumidity, Pump, Ion, TankLevel, Humidity,
+                                              Temperature>();
+};
+
+class StatusData : public FrameData {
+ public:
+  StatusData() : FrameData({0x48, 0x00, MODE_SETPOINT, FAN_MEDIUM, 0x00, 0x00, 0x00, 0x32, 0x00, 0x00,
+                            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                            0x00, 0x00, 0x00, 0x00}) {}
+  StatusData(const FrameData &data) : FrameData(data) {}
+
+  /// Status response or report
+  bool hasStatus() const { return this->hasID(0xC8); }
+  /// Copy writable status from another StatusData
+  void copyStatus(const StatusData &p) { this->copyStatus(p.data()); }
+  /// Copy writable status from 0xC8 payload of at least 10 bytes
+  void copyStatus(const uint8_t *data) { memcpy(this->m_data.data() + 1, data + 1, 9); }
+
+  bool getPower() const { return this->m_get<StatusLayout::Power>(); }
+  void setPower(bool state) { this->m_setFlag<StatusLayout::Power>(state); }
+
+  Mode getMode() const { return static_cast<Mode>(this->m_get<StatusLayout::Mode>()); }
+  void setMode(Mode mode) { this->m_set<StatusLayout::Mode>(mode); }
+
+  FanSpeed getFanSpeed() const { return static_cast<FanSpeed>(this->m_get<StatusLayout::FanSpeed>()); }
+  void setFanSpeed(FanSpeed speed) { this->m_set<StatusLayout::FanSpeed>(speed); }
+
+  /// Humidity setpoint, %
+  uint8_t getTargetHumidity() const { return this->m_get<StatusLayout::TargetHumidity>(); }
+  void setTargetHumidity(uint8_t value) { this->m_set<StatusLayout::TargetHumidity>(value); }
+
+  bool getIon() const { return this->m_get<StatusLayout::Ion>(); }
+  void setIon(bool state) { this->m_setFlag<StatusLayout::Ion>(state); }
+
+  void setBeeper(bool state) {
+    this->m_setFlag<StatusLayout::BeeperEnable>(true);
+    this->m_setFlag<StatusLayout::Beeper>(state);
+  }
+
+  /// Decode all status fields to `state` in single pass over payload
+  void decodeAll(DhState &state) const { StatusData::decodeAll(this->m_data.data(), this->m_data.size(), state); }
+  /// Decode all status fields of 0xC8 payload in place
+  static void decodeAll(const uint8_t *data, uint8_t size, DhState &state);
+};
+
+class QueryStateData : public FrameData {
+ public:
+  QueryStateData() : FrameData({0x41, 0x81, 0x00, 0xFF, 0x03, 0xFF, 0x00, 0x02, 0x00, 0x00,
+                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                0x03, FrameData::m_getID()}) {
+    this->m_hasID = true;
+    this->appendCRC();
+  }
+};
+
+}  // namespace dh
+}  // namespace midea
+}  // namespace dudanov
@@ -0,0 +1,68 @@
+#pragma once
+#include <Arduino.h>
+#include "Appliance/ApplianceBase.h"
+#include "Helpers/Storage.h"
+
+namespace dudanov {
+namespace midea {
+
+/// Appliance identity found by discovery
+struct ApplianceInfo {
+  static const uint8_t MAX_SERIAL_SIZE = 32;
+  /// Serialized size: magic, version, type, protocol, serial size, serial and checksum
+  static const size_t SERIALIZED_SIZE = 3 + 3 + MAX_SERIAL_SIZE + 4;
+  ApplianceType type{BROADCAST};
+  uint8_t protocol{};
+  uint8_t serialSize{};
+  /// Electronic ID payload as reported by appliance
+  uint8_t serialNumber[MAX_SERIAL_SIZE]{};
+  size_t serialize(uint8_t *data, size_t size) const;
+  bool deserialize(const uint8_t *data, size_t size);
+};
+
+using OnDiscoveredCallback = Delegate<void(const ApplianceInfo &)>;
+
+/// Finds out type, protocol version and serial number of appliance on the bus by broadcast
+/// GET_ELECTRONIC_ID(0x07) request, repeated every period until answered. Result may be cached in storage,
+/// so later boots skip discovery. Then driver is created by `create<ApplianceRegistry<...>>()`.
+class Discovery : public ApplianceBase {
+ public:
+  Discovery() : ApplianceBase(BROADCAST) {}
+  /// Set storage for discovery result
+  void setStorage(Storage *storage, const char *key = "appliance") {
+    this->m_storage = storage;
+    this->m_key = key;
+  }
+  /// Forget cached result and discover again on setup
+  void setForce(bool state) { this->m_force = state; }
+  bool isDone() const { return this->m_isDone; }
+  const ApplianceInfo &getInfo() const { return this->m_info; }
+  /// Add listener of discovery result
+  bool addOnDiscoveredCallback(OnDiscoveredCallback cb) { return this->m_callbacks.add(cb); }
+  /// Create driver of discovered appliance from `Registry`. Returns `nullptr` if discovery is not done or type
+  /// is not registered. Driver gets protocol version and serial number, stream must be set by caller.
+  template<typename Registry> ApplianceBase *create() const {
+    if (!this->m_isDone)
+      return nullptr;
+    ApplianceBase *appliance = Registry::create(this->m_info.type);
+    if (appliance != nullptr) {
+      appliance->setProtocol(this->m_info.protocol);
+      appliance->setSerialNumber(this->m_info.serialNumber, this->m_info.serialSize);
+    }
+    return appliance;
+  }
+
+ protected:
+  void m_setup() override;
+  void m_onIdle() override;
+  void m_onElectronicID(const Frame &frame);
+  DelegateList<void(const ApplianceInfo &), 2> m_callbacks;
+  ApplianceInfo m_info{};
+  Storage *m_storage{};
+  const char *m_key{};
+  bool m_force{};
+  bool m_isDone{};
+};
+
+}  // namespace midea
+}  // namespace dudanov
@@ -0,0 +1,39 @@
+#pragma once
+#include <Arduino.h>
+#include "Appliance/AirConditioner/AirConditioner.h"
+#include "Appliance/AirToWater/AirToWater.h"
+#include "Appliance/Dehumidifier/Dehumidifier.h"
+#include "Appliance/Discovery.h"
+#include "Helpers/Memory.h"
+
+namespace dudanov {
+namespace midea {
+
+/// Static size of library class, bytes
+struct ClassSize {
+  const char *name;
+  size_t size;
+};
+
+/// Static sizes of library classes. Known at compile time, so RAM budget may be checked by `static_assert`.
+inline constexpr ClassSize CLASS_SIZES[] = {
+  {"ApplianceBase", sizeof(ApplianceBase)},
+  {"ac::AirConditioner", sizeof(ac::AirConditioner)},
+  {"ac::AcState", sizeof(ac::AcState)},
+  {"ac::Capabilities", sizeof(ac::Capabilities)},
+  {"ac::StatusData", sizeof(ac::StatusData)},
+  {"ac::EnergyMeter", sizeof(ac::EnergyMeter)},
+  {"ac::TimeSeries", sizeof(ac::TimeSeries)},
+  {"dh::Dehumidifier", sizeof(dh::Dehumidifier)},
+  {"a2w::AirToWater", sizeof(a2w::AirToWater)},
+  {"Discovery", sizeof(Discovery)},
+  {"Frame", sizeof(Frame)},
+  {"FrameData", sizeof(FrameData)},
+  {"Timer", sizeof(Timer)},
+};
+
+/// Log static class sizes, heap usage of `appliance` (if not `nullptr`) and allocation statistics
+void dumpMemory(const ApplianceBase *appliance = nullptr);
+
+}  // namespace midea
+}  // namespace dudanov
@@ -0,0 +1,55 @@
+#pragma once
+#include <Arduino.h>
+
+namespace dudanov {
+namespace midea {
+
+/// Network status reported to appliance
+struct NetworkStatus {
+  /// IPv4 address, most significant byte first
+  uint8_t ip[4];
+  /// Signal strength: 1..4
+  uint8_t signalStrength;
+  bool connected;
+};
+
+/// Source of network status for NETWORK_NOTIFY(0x0D) and QUERY_NETWORK(0x63) answers.
+/// Status is read only when revision changes and on periodic notify, never on answering.
+class NetworkProvider {
+ public:
+  virtual ~NetworkProvider() = default;
+  virtual NetworkStatus getStatus() = 0;
+  /// Incremented on network events. Appliance refreshes its cached status on change.
+  virtual uint32_t getRevision() { return 0; }
+};
+
+/// Fixed status set by user. Default for targets without WiFi, e.g. host builds and tests.
+class StaticNetworkProvider : public NetworkProvider {
+ public:
+  /// Default: connected with full signal strength and unknown IP
+  StaticNetworkProvider() : m_status{{0, 0, 0, 0}, 4, true} {}
+  StaticNetworkProvider(const NetworkStatus &status) : m_status(status) {}
+  /// Set new status. Appliances refresh their cached status on next loop.
+  void setStatus(const NetworkStatus &status) {
+    this->m_status = status;
+    ++this->m_revision;
+  }
+  NetworkStatus getStatus() override { return this->m_status; }
+  uint32_t getRevision() override { return this->m_revision; }
+
+ protected:
+  NetworkStatus m_status;
+  uint32_t m_revision{};
+};
+
+#if defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_ESP8266)
+/// Status of WiFi station. Revision is incremented on connection and IP events.
+class WiFiProvider : public NetworkProvider {
+ public:
+  NetworkStatus getStatus() override;
+  uint32_t getRevision() override;
+};
+#endif
+
+}  // namespace midea
+}  // namespace dudanov
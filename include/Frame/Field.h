@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <initializer_list>
+
+namespace dudanov {
+namespace midea {
+
+/// Compile-time description of payload bit field: byte index, value mask and shift.
+/// Accessors compile to a single load/mask (and store) without runtime parameters.
+template<uint8_t Index, uint8_t Mask = 0xFF, uint8_t Shift = 0>
+struct Field {
+  static constexpr uint8_t INDEX = Index;
+  static constexpr uint8_t MASK = Mask;
+  static constexpr uint8_t SHIFT = Shift;
+  /// Get unchecked field value
+  static constexpr uint8_t get(const uint8_t *data) { return (data[Index] >> Shift) & Mask; }
+  /// Set unchecked field value
+  static void set(uint8_t *data, uint8_t value) {
+    data[Index] &= ~(Mask << Shift);
+    data[Index] |= (value << Shift);
+  }
+  /// Set all field bits to `state`
+  static void setFlag(uint8_t *data, bool state) { set(data, state ? Mask : 0); }
+};
+
+/// Maximal byte index of fields plus one. Minimal payload size for unchecked access.
+template<typename... Fields>
+constexpr uint8_t fieldsSize() {
+  uint8_t size = 0;
+  for (uint8_t idx : {Fields::INDEX...})
+    if (idx >= size)
+      size = idx + 1;
+  return size;
+}
+
+}  // namespace midea
+}  // namespace dudanov
@@ -15,15 +15,21 @@ class Frame {
     this->setData(data);
   }
   FrameData getData() const { return FrameData(this->m_data.data() + OFFSET_DATA, this->m_len() - OFFSET_DATA); }
+  /// Payload in frame buffer without copying. Valid while frame is not changed.
+  const uint8_t *getPayload() const { return this->m_data.data() + OFFSET_DATA; }
+  uint8_t getPayloadSize() const { return this->m_len() - OFFSET_DATA; }
   void setData(const FrameData &data);
   bool isValid() const { return !this->m_calcCS(); }
 
   const uint8_t *data() const { return this->m_data.data(); }
   uint8_t size() const { return this->m_data.size(); }
+  /// Heap used by buffer, bytes
+  size_t capacity() const { return this->m_data.capacity(); }
   void setType(uint8_t value) { this->m_data[OFFSET_TYPE] = value; }
   bool hasType(uint8_t value) const { return this->m_data[OFFSET_TYPE] == value; }
   void setProtocol(uint8_t value) { this->m_data[OFFSET_PROTOCOL] = value; }
   uint8_t getProtocol() const { return this->m_data[OFFSET_PROTOCOL]; }
+  uint8_t getAppliance() const { return this->m_data[OFFSET_APPTYPE]; }
   String toString() const;
 
  protected:
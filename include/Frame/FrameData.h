@@ -1,6 +1,7 @@
 #pragma once
 #include <Arduino.h>
 #include <vector>
+#include "Frame/Field.h"
 
 class IPAddress;
 
@@ -17,6 +18,8 @@ class FrameData {
   template<typename T> T to() { return std::move(*this); }
   const uint8_t *data() const { return this->m_data.data(); }
   uint8_t size() const { return this->m_data.size(); }
+  /// Heap used by buffer, bytes
+  size_t capacity() const { return this->m_data.capacity(); }
   bool hasID(uint8_t value) const { return this->m_data[0] == value; }
   bool hasStatus() const { return this->hasID(0xC0); }
   bool hasPowerInfo() const { return this->hasID(0xC1); }
@@ -26,8 +29,13 @@ class FrameData {
     this->appendCRC();
   }
   bool hasValidCRC() const { return !this->m_calcCRC(); }
+  /// Request carries rolling message ID
+  bool hasMessageID() const { return this->m_hasID; }
+  /// Message ID: byte before CRC
+  uint8_t getMessageID() const { return (this->m_data.size() >= 2) ? this->m_data[this->m_data.size() - 2] : 0; }
  protected:
   std::vector<uint8_t> m_data;
+  bool m_hasID{};
   static uint8_t m_id;
   static uint8_t m_getID() { return FrameData::m_id++; }
   static uint8_t m_getRandom() { return random(256); }
@@ -38,6 +46,10 @@ class FrameData {
     this->m_data[idx] |= (value << shift);
   }
   void m_setMask(uint8_t idx, bool state, uint8_t mask = 255) { this->m_setValue(idx, state ? mask : 0, mask); }
+  /// Get value of field described by `Field` template. Returns 0 if data is too short.
+  template<typename F> uint8_t m_get() const { return (F::INDEX < this->m_data.size()) ? F::get(this->m_data.data()) : 0; }
+  template<typename F> void m_set(uint8_t value) { F::set(this->m_data.data(), value); }
+  template<typename F> void m_setFlag(bool state) { F::setFlag(this->m_data.data(), state); }
 };
 
 class NetworkNotifyData : public FrameData {
@@ -47,6 +59,8 @@ class NetworkNotifyData : public FrameData {
   void setConnected(bool state) { this->m_setMask(8, !state, 1); }
   void setSignalStrength(uint8_t value) { this->m_setValue(2, value); }
   void setIP(const IPAddress &ip);
+  /// Set IPv4 address, most significant byte first
+  void setIP(const uint8_t *ip);
 };
 
 }  // namespace midea
@@ -0,0 +1,68 @@
+#pragma once
+#if defined(__linux__) && !defined(ARDUINO)
+#include <vector>
+#include "Appliance/ApplianceBase.h"
+#include "Helpers/TimerWheel.h"
+#include "Transport/SocketTransport.h"
+
+namespace dudanov {
+namespace midea {
+
+/// Linux host runtime driving many appliances from one thread. Readiness of their descriptors (tty, pty or
+/// sockets) is waited by `epoll`, their next deadlines are kept in shared timer wheel. Appliance loop runs only
+/// on input or due deadline, so idle appliances cost nothing.
+///
+/// All appliances share process clock `TimerManager::ms()`, so gateway and appliances must be used from one thread.
+class Gateway {
+ public:
+  Gateway();
+  Gateway(const Gateway &) = delete;
+  Gateway &operator=(const Gateway &) = delete;
+  ~Gateway();
+  /// Add appliance talking over opened descriptor. Gateway takes ownership of descriptor, sets appliance transport
+  /// and calls its `setup()`. Returns `false` on failure.
+  bool add(ApplianceBase &appliance, int fd);
+  /// Add appliance on serial port or pty `path`
+  bool addSerial(ApplianceBase &appliance, const char *path);
+  /// Remove appliance and close its descriptor. May be called from appliance callbacks: device is freed after
+  /// current iteration of `poll()`.
+  void remove(ApplianceBase &appliance);
+  /// Run appliance loop on next iteration. Needed after `control()` called outside of appliance callbacks.
+  void wake(ApplianceBase &appliance);
+  /// Set heap budget of request queue of each appliance added after this call, bytes. Default: 0, unlimited.
+  void setMemoryBudget(size_t bytes) { this->m_memoryBudget = bytes; }
+  /// Number of appliances
+  size_t size() const { return this->m_devices.size(); }
+  /// Wait for input or deadline up to `timeout` ms (-1: infinite) and run ready appliances.
+  /// Returns number of appliance loops.
+  unsigned poll(int timeout = -1);
+  /// Poll until `stop()`
+  void run();
+  void stop() { this->m_isRunning = false; }
+
+ protected:
+  struct Device : TimerWheel::Entry {
+    // `nullptr`: removed while dispatching
+    ApplianceBase *appliance;
+    SocketTransport transport;
+    // Descriptor is waited for writing
+    bool isWriting;
+  };
+  static const int MAX_EVENTS = 64;
+  Device *m_find(const ApplianceBase &appliance) const;
+  bool m_add(ApplianceBase &appliance, Device *device);
+  // Run appliance loop and schedule its next deadline
+  void m_run(Device &device);
+  std::vector<Device *> m_devices;
+  // Devices removed while dispatching. Events of current iteration may still point to them.
+  std::vector<Device *> m_removed;
+  TimerWheel m_wheel{};
+  size_t m_memoryBudget{};
+  int m_epoll{-1};
+  bool m_isRunning{};
+  bool m_isDispatching{};
+};
+
+}  // namespace midea
+}  // namespace dudanov
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace dudanov {
+
+template<typename Signature> class Delegate;
+
+/// Allocation-free callable. Holds a function pointer, a captureless lambda or a lambda capturing
+/// up to two pointers (typically `[this]`) inline. Calls go through a single function pointer.
+template<typename R, typename... Args>
+class Delegate<R(Args...)> {
+ public:
+  Delegate() = default;
+  Delegate(std::nullptr_t) {}
+  template<typename Fn, typename = typename std::enable_if<!std::is_same<typename std::decay<Fn>::type, Delegate>::value>::type>
+  Delegate(Fn fn) {
+    static_assert(sizeof(Fn) <= sizeof(m_storage), "Callable is too big for Delegate. Capture less.");
+    static_assert(alignof(Fn) <= alignof(void *), "Callable alignment is not supported by Delegate.");
+    static_assert(std::is_trivially_copyable<Fn>::value, "Callable must be trivially copyable.");
+    new (m_storage) Fn(fn);
+    m_invoke = [](void *storage, Args... args) -> R { return (*static_cast<Fn *>(storage))(std::forward<Args>(args)...); };
+  }
+  /// Bind member function at compile time: `Delegate<void()>::bind<&Class::method>(obj)`.
+  template<auto Method, typename T>
+  static Delegate bind(T *obj) {
+    return [obj](Args... args) -> R { return (obj->*Method)(std::forward<Args>(args)...); };
+  }
+  R operator()(Args... args) const { return m_invoke(const_cast<unsigned char *>(m_storage), std::forward<Args>(args)...); }
+  explicit operator bool() const { return m_invoke != nullptr; }
+  bool operator==(std::nullptr_t) const { return m_invoke == nullptr; }
+  bool operator!=(std::nullptr_t) const { return m_invoke != nullptr; }
+
+ private:
+  alignas(void *) unsigned char m_storage[2 * sizeof(void *)]{};
+  R (*m_invoke)(void *, Args...){nullptr};
+};
+
+/// Fixed-capacity list of delegates. Registration never allocates.
+template<typename Signature, size_t N>
+class DelegateList {
+ public:
+  /// Returns `false` if list is full.
+  bool add(Delegate<Signature> delegate) {
+    if (m_size >= N || delegate == nullptr)
+      return false;
+    m_items[m_size++] = delegate;
+    return true;
+  }
+  template<typename... Args>
+  void call(Args &&...args) const {
+    for (size_t n = 0; n < m_size; ++n)
+      m_items[n](args...);
+  }
+  size_t size() const { return m_size; }
+
+ private:
+  Delegate<Signature> m_items[N];
+  size_t m_size{};
+};
+
+}  // namespace dudanov
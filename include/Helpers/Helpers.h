@@ -28,4 +28,47 @@ class Optional {
   bool hasValue_{};
 };
 
+/// Write little-endian 32-bit value. Returns pointer past written data.
+inline uint8_t *putU32(uint8_t *data, uint32_t value) {
+  for (uint8_t n = 0; n < 4; ++n, value >>= 8)
+    *data++ = value;
+  return data;
+}
+
+/// Read little-endian 32-bit value
+inline uint32_t getU32(const uint8_t *data) {
+  return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+/// ZigZag encoding of signed value: small magnitudes give small codes
+inline uint32_t zigzag(int32_t value) { return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31); }
+inline int32_t unzigzag(uint32_t value) { return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1); }
+
+/// Write LEB128 varint. Returns pointer past written data (up to 5 bytes).
+inline uint8_t *putVarint(uint8_t *data, uint32_t value) {
+  for (; value >= 0x80; value >>= 7)
+    *data++ = value | 0x80;
+  *data++ = value;
+  return data;
+}
+
+/// Read LEB128 varint. Returns pointer past read data or `nullptr` if data is truncated.
+inline const uint8_t *getVarint(const uint8_t *data, const uint8_t *end, uint32_t &value) {
+  value = 0;
+  for (uint8_t shift = 0; data < end && shift < 35; shift += 7) {
+    const uint8_t byte = *data++;
+    value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return data;
+  }
+  return nullptr;
+}
+
+/// FNV-1a 32-bit hash. May be chained by passing previous result as `hash`.
+inline uint32_t fnv1a(const uint8_t *data, size_t size, uint32_t hash = 2166136261UL) {
+  while (size--)
+    hash = (hash ^ *data++) * 16777619UL;
+  return hash;
+}
+
 }  // namespace dudanov
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace dudanov {
+
+/// Heap allocation statistics
+struct AllocStats {
+  uint32_t numAllocs;
+  uint32_t numFrees;
+  /// Live bytes
+  size_t bytes;
+  /// Maximum of live bytes
+  size_t peakBytes;
+};
+
+/// Allocations of one call site
+struct AllocSite {
+  /// Return address in caller of `operator new`. May be resolved by `addr2line`.
+  const void *address;
+  uint32_t numAllocs;
+  /// Allocated bytes, freed ones included
+  size_t bytes;
+};
+
+/// Heap allocations counted by replaced global `operator new`. Available in native builds with
+/// `MIDEA_TRACK_ALLOCATIONS` flag, otherwise statistics are always zero. Not thread-safe.
+class AllocTracker {
+ public:
+  /// Maximum number of tracked call sites. Allocations of other sites are counted in totals only.
+  static const uint8_t MAX_SITES = 64;
+  static bool isEnabled();
+  /// Reset statistics, e.g. before measured session. Live bytes are kept.
+  static void reset();
+  static AllocStats getStats();
+  static uint8_t getNumSites();
+  static const AllocSite &getSite(uint8_t idx);
+};
+
+}  // namespace dudanov
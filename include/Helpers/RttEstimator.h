@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+
+namespace dudanov {
+
+/// Round-trip time estimator with smoothed mean and mean deviation (Jacobson/Karels, as TCP RTO).
+/// Integer arithmetic only. All values in ms.
+class RttEstimator {
+ public:
+  /// Add round-trip time sample. Samples of retransmitted requests must not be added (Karn's rule).
+  void addSample(uint32_t rtt);
+  void reset() { *this = RttEstimator(); }
+  bool hasSamples() const { return this->m_numSamples; }
+  /// Smoothed round-trip time
+  uint32_t getSmoothed() const { return this->m_srtt >> 3; }
+  /// Round-trip time mean deviation
+  uint32_t getDeviation() const { return this->m_rttvar >> 2; }
+  /// Response timeout `SRTT + 4 * RTTVAR` clamped to [`min`, `max`]
+  uint32_t getTimeout(uint32_t min, uint32_t max) const;
+  uint32_t getLast() const { return this->m_last; }
+  uint32_t getMin() const { return this->m_min; }
+  uint32_t getMax() const { return this->m_max; }
+  uint32_t getNumSamples() const { return this->m_numSamples; }
+
+ private:
+  // Smoothed RTT scaled by 8
+  uint32_t m_srtt{};
+  // Mean deviation scaled by 4
+  uint32_t m_rttvar{};
+  uint32_t m_last{};
+  uint32_t m_min{UINT32_MAX};
+  uint32_t m_max{};
+  uint32_t m_numSamples{};
+};
+
+}  // namespace dudanov
@@ -0,0 +1,57 @@
+#pragma once
+#include <Arduino.h>
+
+namespace dudanov {
+
+/// Persistent storage of small binary blobs addressed by short keys (up to 15 chars).
+class Storage {
+ public:
+  virtual ~Storage() = default;
+  /// Load blob to `data`. Returns number of read bytes or 0 on failure.
+  virtual size_t load(const char *key, uint8_t *data, size_t size) = 0;
+  /// Save blob. Returns `true` on success.
+  virtual bool save(const char *key, const uint8_t *data, size_t size) = 0;
+};
+
+/// Stores blobs as files in directory. Works with host filesystem and with filesystems mounted to VFS
+/// (LittleFS, SPIFFS) on ESP32. Use `LittleFsStorage` on ESP8266.
+class FileStorage : public Storage {
+ public:
+  FileStorage(const char *dir) : m_dir(dir) {}
+  size_t load(const char *key, uint8_t *data, size_t size) override;
+  bool save(const char *key, const uint8_t *data, size_t size) override;
+
+ protected:
+  String m_path(const char *key) const;
+  const char *m_dir;
+};
+
+#ifdef ARDUINO_ARCH_ESP8266
+/// Stores blobs as files in directory of LittleFS. Filesystem is mounted on first access and formatted
+/// if it can't be mounted.
+class LittleFsStorage : public FileStorage {
+ public:
+  LittleFsStorage(const char *dir = "/midea") : FileStorage(dir) {}
+  size_t load(const char *key, uint8_t *data, size_t size) override;
+  bool save(const char *key, const uint8_t *data, size_t size) override;
+
+ protected:
+  bool m_mount();
+  bool m_isMounted{};
+};
+#endif
+
+#ifdef ARDUINO_ARCH_ESP32
+/// Stores blobs in NVS namespace via `Preferences`.
+class NvsStorage : public Storage {
+ public:
+  NvsStorage(const char *name = "midea") : m_name(name) {}
+  size_t load(const char *key, uint8_t *data, size_t size) override;
+  bool save(const char *key, const uint8_t *data, size_t size) override;
+
+ protected:
+  const char *m_name;
+};
+#endif
+
+}  // namespace dudanov
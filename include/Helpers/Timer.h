@@ -1,20 +1,24 @@
 #pragma once
 #include <cstdint>
-#include <functional>
 #include <list>
+#include "Helpers/Delegate.h"
 
 namespace dudanov {
 
 class Timer;
 using TimerTick = unsigned long;
-using TimerCallback = std::function<void(Timer *)>;
+using TimerCallback = Delegate<void(Timer *)>;
 using Timers = std::list<Timer *>;
 
 class TimerManager {
  public:
   static TimerTick ms() { return TimerManager::s_millis; }
+  /// Update current time. Called by `task()`.
+  static TimerTick update();
   void registerTimer(Timer &timer) { m_timers.push_back(&timer); }
   void task();
+  /// Time to nearest expiration of enabled timers, ms. `UINT32_MAX` if all timers are stopped.
+  uint32_t getDelay() const;
 
  private:
   static TimerTick s_millis;
@@ -26,6 +30,11 @@ class Timer {
   Timer();
   bool isExpired() const { return TimerManager::ms() - this->m_last >= this->m_alarm; }
   bool isEnabled() const { return this->m_alarm; }
+  /// Time to expiration, ms
+  TimerTick remaining() const {
+    const TimerTick elapsed = TimerManager::ms() - this->m_last;
+    return elapsed >= this->m_alarm ? 0 : this->m_alarm - elapsed;
+  }
   void start(TimerTick ms) {
     this->m_alarm = ms;
     this->reset();
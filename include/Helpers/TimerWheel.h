@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include "Helpers/Timer.h"
+
+namespace dudanov {
+
+/// Hashed timer wheel with 1 ms resolution: O(1) scheduling and cancelling of deadlines of many objects.
+/// Entries are intrusive, so wheel never allocates. Deadlines beyond one revolution wait in their slot.
+class TimerWheel {
+ public:
+  /// Intrusive entry. Embed it into scheduled object.
+  struct Entry {
+    Entry *prev{};
+    Entry *next{};
+    TimerTick deadline{};
+    uint16_t slot{};
+    bool isScheduled{};
+  };
+  /// Schedule or reschedule entry. Past deadline expires on next `pop()`.
+  void schedule(Entry &entry, TimerTick deadline);
+  void cancel(Entry &entry);
+  /// Remove and return next entry expired by `now` or `nullptr`. Wheel is advanced to `now`.
+  Entry *pop(TimerTick now);
+  /// Time to earliest deadline after all expired entries are popped, ms. Not greater than `max`.
+  uint32_t getDelay(TimerTick now, uint32_t max) const;
+  /// Number of scheduled entries
+  uint32_t size() const { return this->m_size; }
+
+ private:
+  static const uint16_t NUM_SLOTS = 1024;
+  static uint16_t m_index(TimerTick time) { return time % NUM_SLOTS; }
+  // Slot lists
+  Entry *m_slots[NUM_SLOTS]{};
+  // Current position
+  TimerTick m_time{};
+  uint32_t m_size{};
+};
+
+}  // namespace dudanov
@@ -0,0 +1,56 @@
+#pragma once
+#if !defined(ARDUINO) && (defined(__unix__) || defined(__APPLE__))
+#include "Transport/Transport.h"
+
+namespace dudanov {
+namespace midea {
+
+/// Non-blocking POSIX descriptor transport for host builds: TCP or UDP link to serial server (RS-485/serial
+/// gateways), or any opened descriptor like tty or pty. Reads are served from buffer filled by single system call,
+/// writes are buffered until `flush()`.
+class SocketTransport : public Transport {
+ public:
+  SocketTransport() = default;
+  SocketTransport(const SocketTransport &) = delete;
+  SocketTransport &operator=(const SocketTransport &) = delete;
+  ~SocketTransport() override { this->close(); }
+  /// Connect to TCP server. Returns `false` on failure.
+  bool connectTcp(const char *host, uint16_t port) { return this->m_connect(host, port, false); }
+  /// Connect UDP socket to remote peer. Returns `false` on failure.
+  bool connectUdp(const char *host, uint16_t port) { return this->m_connect(host, port, true); }
+  /// Take ownership of opened descriptor. It is switched to non-blocking mode.
+  bool open(int fd);
+  /// Open serial port or pty `path` in raw `9600 8N1` mode. Returns `false` on failure.
+  bool openSerial(const char *path);
+  void close();
+  bool isOpen() const { return this->m_fd >= 0; }
+  /// Descriptor for readiness waiting by `poll()` or `epoll`
+  int getFd() const { return this->m_fd; }
+  /// Number of bytes waiting in send buffer
+  size_t getPending() const { return this->m_txLen; }
+  /// Returns 0 if no data is available. Descriptor is closed on error or end of stream.
+  size_t read(uint8_t *data, size_t size) override;
+  /// Frame is buffered whole. Returns 0 if it doesn't fit in buffer after flush.
+  size_t write(const uint8_t *data, size_t size) override;
+  /// Send buffer. Unsent rest is kept for next flush if descriptor is not ready.
+  void flush() override;
+
+ protected:
+  static const size_t RX_BUFFER_SIZE = 512;
+  static const size_t TX_BUFFER_SIZE = 512;
+  bool m_connect(const char *host, uint16_t port, bool udp);
+  // Write without buffering. Returns number of written bytes.
+  size_t m_send(const uint8_t *data, size_t size);
+  // Whole datagram fits in receive buffer
+  uint8_t m_rxBuf[RX_BUFFER_SIZE];
+  size_t m_rxPos{};
+  size_t m_rxLen{};
+  uint8_t m_txBuf[TX_BUFFER_SIZE];
+  size_t m_txLen{};
+  int m_fd{-1};
+  bool m_isSocket{};
+};
+
+}  // namespace midea
+}  // namespace dudanov
+#endif
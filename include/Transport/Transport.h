@@ -0,0 +1,38 @@
+#pragma once
+#include <Arduino.h>
+
+namespace dudanov {
+namespace midea {
+
+/// Byte transport of UART protocol frames
+class Transport {
+ public:
+  virtual ~Transport() = default;
+  /// Read up to `size` available bytes without blocking. Returns number of read bytes.
+  virtual size_t read(uint8_t *data, size_t size) = 0;
+  /// Write frame bytes. Buffered transports send them on `flush()`. Returns number of accepted bytes: less than
+  /// `size` means that frame is dropped.
+  virtual size_t write(const uint8_t *data, size_t size) = 0;
+  /// Send buffered bytes. Called once per appliance loop, so frames of one loop are sent together.
+  virtual void flush() {}
+};
+
+/// Arduino `Stream` transport: hardware or software serial
+class StreamTransport : public Transport {
+ public:
+  void setStream(Stream *stream) { this->m_stream = stream; }
+  Stream *getStream() const { return this->m_stream; }
+  size_t read(uint8_t *data, size_t size) override {
+    size_t num = 0;
+    while (num < size && this->m_stream->available())
+      data[num++] = this->m_stream->read();
+    return num;
+  }
+  size_t write(const uint8_t *data, size_t size) override { return this->m_stream->write(data, size); }
+
+ protected:
+  Stream *m_stream{};
+};
+
+}  // namespace midea
+}  // namespace dudanov
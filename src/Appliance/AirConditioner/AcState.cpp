@@ -0,0 +1,32 @@
+#include "Appliance/AirConditioner/AcState.h"
+
+namespace dudanov {
+namespace midea {
+namespace ac {
+
+uint16_t AcState::diff(const AcState &other) const {
+  uint16_t mask = 0;
+  if (this->mode != other.mode)
+    mask |= CHANGE_MODE;
+  if (this->preset != other.preset)
+    mask |= CHANGE_PRESET;
+  if (this->fanMode != other.fanMode)
+    mask |= CHANGE_FAN_MODE;
+  if (this->swingMode != other.swingMode)
+    mask |= CHANGE_SWING_MODE;
+  if (this->targetTemp != other.targetTemp)
+    mask |= CHANGE_TARGET_TEMP;
+  if (this->indoorTemp != other.indoorTemp)
+    mask |= CHANGE_INDOOR_TEMP;
+  if (this->outdoorTemp != other.outdoorTemp)
+    mask |= CHANGE_OUTDOOR_TEMP;
+  if (this->humiditySetpoint != other.humiditySetpoint)
+    mask |= CHANGE_HUMIDITY_SETPOINT;
+  if (this->powerUsage != other.powerUsage)
+    mask |= CHANGE_POWER_USAGE;
+  return mask;
+}
+
+}  // namespace ac
+}  // namespace midea
+}  // namespace dudanov
@@ -8,15 +8,27 @@ namespace ac {
 
 static const char *TAG = "AirConditioner";
 
+bool AcDescriptor::decodeStatus(const uint8_t *data, uint8_t size, AcState &state) {
+  // Writable part of status is copied to control frames
+  if (size < 11)
+    return false;
+  StatusData::decodeAll(data, size, state);
+  return true;
+}
+
+bool AcDescriptor::decodePower(const uint8_t *data, uint8_t size, AcState &state) {
+  if (size < 19)
+    return false;
+  state.powerUsage = StatusData::decodePowerUsage(data);
+  return true;
+}
+
 void AirConditioner::m_setup() {
-  if (this->m_autoconfStatus != AUTOCONF_DISABLED)
+  this->m_restoreEnergy();
+  // Startup sequence: status first, then power usage and capabilities
+  Appliance::m_setup();
+  if (this->m_autoconfStatus != AUTOCONF_DISABLED && !this->m_restoreCapabilities())
     this->m_getCapabilities();
-  this->m_timerManager.registerTimer(this->m_powerUsageTimer);
-  this->m_powerUsageTimer.setCallback([this](Timer *timer) {
-    timer->reset();
-    this->m_getPowerUsage();
-  });
-  this->m_powerUsageTimer.start(30000);
 }
 
 static bool checkConstraints(const Mode &mode, const Preset &preset) {
@@ -38,19 +50,51 @@ static bool checkConstraints(const Mode &mode, const Preset &preset) {
   }
 }
 
-void AirConditioner::control(const Control &control) {
-  if (this->m_sendControl)
+Optional<int16_t> Control::getTargetTempTenths() const {
+  if (this->targetTempTenths.hasValue() || !this->targetTemp.hasValue())
+    return this->targetTempTenths;
+  return static_cast<int16_t>(lroundf(this->targetTemp.value() * 10.0F));
+}
+
+Control &Control::merge(const Control &other) {
+  const Optional<int16_t> targetTemp = other.getTargetTempTenths();
+  if (targetTemp.hasValue()) {
+    this->targetTempTenths = targetTemp;
+    this->targetTemp.clear();
+  }
+  if (other.mode.hasValue())
+    this->mode = other.mode;
+  if (other.preset.hasValue())
+    this->preset = other.preset;
+  if (other.fanMode.hasValue())
+    this->fanMode = other.fanMode;
+  if (other.swingMode.hasValue())
+    this->swingMode = other.swingMode;
+  if (other.beeper.hasValue())
+    this->beeper = other.beeper;
+  this->displayToggle ^= other.displayToggle;
+  return *this;
+}
+
+void AirConditioner::control(const Control &control, ControlCallback onComplete) {
+  if (this->m_sendControl) {
+    LOG_W(TAG, "Previous control is in progress. Control dropped.");
+    if (onComplete != nullptr)
+      onComplete(false);
     return;
+  }
+  if (control.beeper.hasValue())
+    this->setBeeper(control.beeper.value());
   StatusData status = this->m_status;
-  Mode mode = this->m_mode;
-  Preset preset = this->m_preset;
+  Mode mode = this->m_state.mode;
+  Preset preset = this->m_state.preset;
   bool hasUpdate = false;
   bool isModeChanged = false;
   if (control.mode.hasUpdate(mode)) {
     hasUpdate = true;
     isModeChanged = true;
     mode = control.mode.value();
-    if (this->m_mode == Mode::MODE_OFF)
+    if (this->m_state.mode == Mode::MODE_OFF)
       preset = this->m_lastPreset;
     else if (!checkConstraints(mode, preset))
       preset = Preset::PRESET_NONE;
@@ -61,63 +105,81 @@ void AirConditioner::control(const Control &control) {
   }
   if (mode != Mode::MODE_OFF) {
     if (mode == Mode::MODE_AUTO || preset != Preset::PRESET_NONE) {
-      if (this->m_fanMode != FanMode::FAN_AUTO) {
+      if (this->m_state.fanMode != FanMode::FAN_AUTO) {
         hasUpdate = true;
         status.setFanMode(FanMode::FAN_AUTO);
       }
-    } else if (control.fanMode.hasUpdate(this->m_fanMode)) {
+    } else if (control.fanMode.hasUpdate(this->m_state.fanMode)) {
       hasUpdate = true;
       status.setFanMode(control.fanMode.value());
     }
-    if (control.swingMode.hasUpdate(this->m_swingMode)) {
+    if (control.swingMode.hasUpdate(this->m_state.swingMode)) {
       hasUpdate = true;
       status.setSwingMode(control.swingMode.value());
     }
   }
-  if (control.targetTemp.hasUpdate(this->m_targetTemp)) {
+  const Optional<int16_t> targetTemp = control.getTargetTempTenths();
+  if (targetTemp.hasUpdate(this->m_state.targetTemp)) {
     hasUpdate = true;
-    status.setTargetTemp(control.targetTemp.value());
+    status.setTargetTempTenths(targetTemp.value());
+  }
+  if (!hasUpdate && !control.displayToggle) {
+    if (onComplete != nullptr)
+      onComplete(true);
+    return;
   }
+  this->m_sendControl = true;
+  this->m_controlCallback = onComplete;
+  // All frames are sent in order. If one fails, rest of them are dropped.
+  this->m_beginGroup();
   if (hasUpdate) {
-    this->m_sendControl = true;
     status.setMode(mode);
     status.setPreset(preset);
     status.setBeeper(this->m_beeper);
     status.appendCRC();
     if (isModeChanged && preset != Preset::PRESET_NONE && preset != Preset::PRESET_SLEEP) {
-      // Last command with preset
-      this->m_setStatus(status);
-      status.setPreset(Preset::PRESET_NONE);
-      status.setBeeper(false);
-      status.updateCRC();
-      // First command without preset
-      this->m_queueRequestPriority(FrameType::DEVICE_CONTROL, std::move(status),
-        // onData
-        std::bind(&AirConditioner::m_readStatus, this, std::placeholders::_1)
-      );
-    } else {
-      this->m_setStatus(std::move(status));
+      // Appliance accepts preset only in already set mode: first command without preset
+      StatusData first = status;
+      first.setPreset(Preset::PRESET_NONE);
+      first.setBeeper(false);
+      first.updateCRC();
+      this->m_queueControl(FrameType::DEVICE_CONTROL, std::move(first), false);
     }
+    LOG_D(TAG, "Enqueuing a priority SET_STATUS(0x40) request...");
+    this->m_queueControl(FrameType::DEVICE_CONTROL, std::move(status), !control.displayToggle);
   }
+  if (control.displayToggle) {
+    LOG_D(TAG, "Enqueuing a priority TOGGLE_LIGHT(0x41) request...");
+    this->m_queueControl(FrameType::DEVICE_QUERY, DisplayToggleData{}, true);
+  }
+  this->m_endGroup();
 }
 
-void AirConditioner::m_setStatus(StatusData status) {
-  LOG_D(TAG, "Enqueuing a priority SET_STATUS(0x40) request...");
-  this->m_queueRequestPriority(FrameType::DEVICE_CONTROL, std::move(status),
+void AirConditioner::m_queueControl(FrameType type, FrameData data, bool isLast) {
+  this->m_queueRequest(type, std::move(data),
     // onData
-    std::bind(&AirConditioner::m_readStatus, this, std::placeholders::_1),
+    ResponseHandler::bind<&AirConditioner::m_readResponse>(this),
     // onSuccess
-    [this]() {
-      this->m_sendControl = false;
-    },
+    isLast ? Handler::bind<&AirConditioner::m_onControlSuccess>(this) : nullptr,
     // onError
-    [this]() {
-      LOG_W(TAG, "SET_STATUS(0x40) request failed...");
-      this->m_sendControl = false;
-    }
+    Handler::bind<&AirConditioner::m_onControlError>(this),
+    PRIORITY_CONTROL
   );
 }
 
+void AirConditioner::m_finishControl(bool success) {
+  // Failed frame drops rest of group with their `onError` calls
+  if (!this->m_sendControl)
+    return;
+  if (!success)
+    LOG_W(TAG, "Control request failed...");
+  this->m_sendControl = false;
+  const ControlCallback callback = this->m_controlCallback;
+  this->m_controlCallback = nullptr;
+  if (callback != nullptr)
+    callback(success);
+}
+
 void AirConditioner::setPowerState(bool state) {
   if (state != this->getPowerState()) {
     Control control;
@@ -126,34 +188,19 @@ void AirConditioner::setPowerState(bool state) {
   }
 }
 
-void AirConditioner::m_getPowerUsage() {
-  QueryPowerData data{};
-  LOG_D(TAG, "Enqueuing a GET_POWERUSAGE(0x41) request...");
-  this->m_queueRequest(FrameType::DEVICE_QUERY, std::move(data),
-    // onData
-    [this](FrameData data) -> ResponseStatus {
-      const auto status = data.to<StatusData>();
-      if (!status.hasPowerInfo())
-        return ResponseStatus::RESPONSE_WRONG;
-      if (this->m_powerUsage != status.getPowerUsage()) {
-        this->m_powerUsage = status.getPowerUsage();
-        this->sendUpdate();
-      }
-      return ResponseStatus::RESPONSE_OK;
-    }
-  );
-}
-
-void AirConditioner::m_getCapabilities() {
+void AirConditioner::m_getCapabilities(RequestPriority priority) {
   GetCapabilitiesData data{};
-  this->m_autoconfStatus = AUTOCONF_PROGRESS;
+  // Capabilities restored from cache remain valid while updating in background
+  if (this->m_autoconfStatus != AUTOCONF_OK)
+    this->m_autoconfStatus = AUTOCONF_PROGRESS;
+  this->m_newCapabilities = Capabilities{};
   LOG_D(TAG, "Enqueuing a priority GET_CAPABILITIES(0xB5) request...");
   this->m_queueRequest(FrameType::DEVICE_QUERY, std::move(data),
     // onData
     [this](FrameData data) -> ResponseStatus {
       if (!data.hasID(0xB5))
         return ResponseStatus::RESPONSE_WRONG;
-      if (this->m_capabilities.read(data)) {
+      if (this->m_newCapabilities.read(data)) {
         GetCapabilitiesSecondData data{};
         this->m_sendFrame(FrameType::DEVICE_QUERY, data);
         return ResponseStatus::RESPONSE_PARTIAL;
@@ -161,24 +208,92 @@ void AirConditioner::m_getCapabilities() {
       return ResponseStatus::RESPONSE_OK;
     },
     // onSuccess
-    [this]() {
-      this->m_autoconfStatus = AUTOCONF_OK;
-    },
+    Handler::bind<&AirConditioner::m_onCapabilities>(this),
     // onError
     [this]() {
       LOG_W(TAG, "Failed to get 0xB5 capabilities report.");
-      this->m_autoconfStatus = AUTOCONF_ERROR;
-    }
+      if (this->m_autoconfStatus == AUTOCONF_PROGRESS)
+        this->m_autoconfStatus = AUTOCONF_ERROR;
+    },
+    priority
   );
 }
 
-void AirConditioner::m_getStatus() {
-  QueryStateData data{};
-  LOG_D(TAG, "Enqueuing a GET_STATUS(0x41) request...");
-  this->m_queueRequest(FrameType::DEVICE_QUERY, std::move(data),
-    // onData
-    std::bind(&AirConditioner::m_readStatus, this, std::placeholders::_1)
-  );
+void AirConditioner::m_onCapabilities() {
+  const bool isChanged = this->m_newCapabilities.fingerprint() != this->m_capabilities.fingerprint();
+  if (isChanged && this->m_autoconfStatus == AUTOCONF_OK)
+    LOG_I(TAG, "Appliance capabilities have changed. Cached ones are replaced.");
+  this->m_capabilities = this->m_newCapabilities;
+  this->m_autoconfStatus = AUTOCONF_OK;
+  // Save only new data to spare flash
+  if (isChanged || this->m_capabilitiesTag != this->m_fingerprint())
+    this->m_saveCapabilities();
+}
+
+uint32_t AirConditioner::m_fingerprint() const {
+  const uint8_t data[] = {this->getType(), this->getProtocol()};
+  const uint32_t hash = fnv1a(data, sizeof(data));
+  if (!this->getSerialHash())
+    return hash;
+  // Same model with other serial number may have other capabilities
+  uint8_t serial[4];
+  putU32(serial, this->getSerialHash());
+  return fnv1a(serial, sizeof(serial), hash);
+}
+
+bool AirConditioner::m_restoreCapabilities() {
+  if (this->m_capabilitiesStorage == nullptr)
+    return false;
+  uint8_t data[Capabilities::SERIALIZED_SIZE];
+  const size_t size = this->m_capabilitiesStorage->load(this->m_capabilitiesKey, data, sizeof(data));
+  if (!this->m_capabilities.deserialize(data, size, this->m_capabilitiesTag)) {
+    LOG_D(TAG, "No valid capabilities in cache.");
+    return false;
+  }
+  LOG_D(TAG, "Capabilities restored from cache.");
+  this->m_autoconfStatus = AUTOCONF_OK;
+  this->m_verifyCapabilities = true;
+  return true;
+}
+
+void AirConditioner::m_saveCapabilities() {
+  if (this->m_capabilitiesStorage == nullptr)
+    return;
+  uint8_t data[Capabilities::SERIALIZED_SIZE];
+  const uint32_t tag = this->m_fingerprint();
+  const size_t size = this->m_capabilities.serialize(data, sizeof(data), tag);
+  if (this->m_capabilitiesStorage->save(this->m_capabilitiesKey, data, size)) {
+    this->m_capabilitiesTag = tag;
+    LOG_D(TAG, "Capabilities saved to cache.");
+  } else
+    LOG_W(TAG, "Failed to save capabilities to cache.");
+}
+
+void AirConditioner::m_restoreEnergy() {
+  if (this->m_energyStorage == nullptr)
+    return;
+  // Uptime restarts from 0, so restored buckets would be ahead of new samples
+  if (this->m_clock == nullptr) {
+    LOG_W(TAG, "Energy meter is not restored: no wall clock is set.");
+    return;
+  }
+  uint8_t data[EnergyMeter::SERIALIZED_SIZE];
+  const size_t size = this->m_energyStorage->load(this->m_energyKey, data, sizeof(data));
+  if (this->m_energyMeter.deserialize(data, size))
+    LOG_D(TAG, "Energy meter restored from storage.");
+}
+
+void AirConditioner::m_addEnergySample(uint32_t counter) {
+  const uint32_t bucketStart = this->m_energyMeter.getBucketStart();
+  this->m_energyMeter.addSample(this->m_getTime(), counter);
+  // Save once per hour to spare flash
+  if (this->m_energyStorage == nullptr || this->m_clock == nullptr ||
+      this->m_energyMeter.getBucketStart() == bucketStart)
+    return;
+  uint8_t data[EnergyMeter::SERIALIZED_SIZE];
+  const size_t size = this->m_energyMeter.serialize(data, sizeof(data));
+  if (!this->m_energyStorage->save(this->m_energyKey, data, size))
+    LOG_W(TAG, "Failed to save energy meter.");
 }
 
 void AirConditioner::m_displayToggle() {
@@ -186,41 +301,37 @@ void AirConditioner::m_displayToggle() {
   LOG_D(TAG, "Enqueuing a priority TOGGLE_LIGHT(0x41) request...");
   this->m_queueRequest(FrameType::DEVICE_QUERY, std::move(data),
     // onData
-    std::bind(&AirConditioner::m_readStatus, this, std::placeholders::_1)
+    ResponseHandler::bind<&AirConditioner::m_readResponse>(this),
+    nullptr, nullptr, PRIORITY_CONTROL
   );
 }
 
-template<typename T>
-void setProperty(T &property, const T &value, bool &update) {
-  if (property != value) {
-    property = value;
-    update = true;
-  }
+MemoryUsage AirConditioner::getMemoryUsage() const {
+  MemoryUsage usage = Appliance::getMemoryUsage();
+  usage.buffers += this->m_status.capacity();
+  return usage;
 }
 
-ResponseStatus AirConditioner::m_readStatus(FrameData data) {
-  if (!data.hasStatus())
-    return ResponseStatus::RESPONSE_WRONG;
-  LOG_D(TAG, "New status data received. Parsing...");
-  bool hasUpdate = false;
-  const StatusData newStatus = data.to<StatusData>();
-  this->m_status.copyStatus(newStatus);
-  if (this->m_mode != newStatus.getMode()) {
-    hasUpdate = true;
-    this->m_mode = newStatus.getMode();
-    if (newStatus.getMode() == Mode::MODE_OFF)
-      this->m_lastPreset = this->m_preset;
+void AirConditioner::m_onDecoded(uint8_t idx, const uint8_t *data, uint8_t /*size*/, AcState &state) {
+  if (idx == AcDescriptor::QUERY_POWER) {
+    this->m_addEnergySample(state.powerUsage);
+    return;
+  }
+  LOG_D(TAG, "New status data received.");
+  this->m_status.copyStatus(data);
+  if (state.mode == Mode::MODE_OFF && this->m_state.mode != Mode::MODE_OFF)
+    this->m_lastPreset = this->m_state.preset;
+  if (this->m_timeSeries != nullptr)
+    this->m_timeSeries->add(this->m_getTime(), state);
+  // Protocol version is known now, so appliance fingerprint may be checked. Type and protocol are same for many
+  // models, so only known serial number identifies appliance of cached capabilities.
+  if (this->m_verifyCapabilities) {
+    this->m_verifyCapabilities = false;
+    if (!this->getSerialHash() || this->m_fingerprint() != this->m_capabilitiesTag) {
+      LOG_D(TAG, "Verifying cached capabilities in background...");
+      this->m_getCapabilities(PRIORITY_POLL);
+    }
   }
-  setProperty(this->m_preset, newStatus.getPreset(), hasUpdate);
-  setProperty(this->m_fanMode, newStatus.getFanMode(), hasUpdate);
-  setProperty(this->m_swingMode, newStatus.getSwingMode(), hasUpdate);
-  setProperty(this->m_targetTemp, newStatus.getTargetTemp(), hasUpdate);
-  setProperty(this->m_indoorTemp, newStatus.getIndoorTemp(), hasUpdate);
-  setProperty(this->m_outdoorTemp, newStatus.getOutdoorTemp(), hasUpdate);
-  setProperty(this->m_indoorHumidity, newStatus.getHumiditySetpoint(), hasUpdate);
-  if (hasUpdate)
-    this->sendUpdate();
-  return ResponseStatus::RESPONSE_OK;
 }
 
 }  // namespace ac
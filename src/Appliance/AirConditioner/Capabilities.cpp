@@ -1,6 +1,8 @@
 #include "Appliance/AirConditioner/Capabilities.h"
 #include "Frame/FrameData.h"
+#include "Helpers/Helpers.h"
 #include "Helpers/Log.h"
+#include <algorithm>
 
 namespace dudanov {
 namespace midea {
@@ -8,31 +10,6 @@ namespace ac {
 
 static const char *TAG = "Capabilities";
 
-enum CapabilityID : uint16_t {
-  CAPABILITY_INDOOR_HUMIDITY = 0x0015,
-  CAPABILITY_SILKY_COOL = 0x0018,
-  CAPABILITY_SMART_EYE = 0x0030,
-  CAPABILITY_WIND_ON_ME = 0x0032,
-  CAPABILITY_WIND_OF_ME = 0x0033,
-  CAPABILITY_ACTIVE_CLEAN = 0x0039,
-  CAPABILITY_ONE_KEY_NO_WIND_ON_ME = 0x0042,
-  CAPABILITY_BREEZE_CONTROL = 0x0043,
-  CAPABILITY_FAN_SPEED_CONTROL = 0x0210,
-  CAPABILITY_PRESET_ECO = 0x0212,
-  CAPABILITY_PRESET_FREEZE_PROTECTION = 0x0213,
-  CAPABILITY_MODES = 0x0214,
-  CAPABILITY_SWING_MODES = 0x0215,
-  CAPABILITY_POWER = 0x0216,
-  CAPABILITY_NEST = 0x0217,
-  CAPABILITY_AUX_ELECTRIC_HEATING = 0x0219,
-  CAPABILITY_PRESET_TURBO = 0x021A,
-  CAPABILITY_HUMIDITY = 0x021F,
-  CAPABILITY_UNIT_CHANGEABLE = 0x0222,
-  CAPABILITY_LIGHT_CONTROL = 0x0224,
-  CAPABILITY_TEMPERATURES = 0x0225,
-  CAPABILITY_BUZZER = 0x022C,
-};
-
 static uint16_t read_u16(const uint8_t *data) { return (data[1] << 8) | data[0]; }
 
 class CapabilityData {
@@ -42,7 +19,7 @@ class CapabilityData {
     m_end(data.data() + data.size() - 1),
     m_num(*(data.data() + 1)) {}
   // Get capability ID
-  CapabilityID id() const { return static_cast<CapabilityID>(read_u16(this->m_it)); }
+  uint16_t id() const { return read_u16(this->m_it); }
   // Read-only indexed access to capability data
   const uint8_t &operator[](uint8_t idx) const { return *(this->m_it + idx + 3); }
   // Get size of capability data
@@ -66,6 +43,164 @@ class CapabilityData {
   uint8_t m_num;
 };
 
+struct Capabilities::Rule {
+  // Capability ID
+  uint16_t id;
+  // Affected flags
+  Flag flags[4];
+  // Flag patterns for capability values. Bit N of pattern is state of `flags[N]`.
+  uint8_t patterns[5];
+  // Number of patterns. Greater values are ignored, or use last pattern if `saturate`.
+  uint8_t num;
+  bool saturate;
+};
+
+#define FLAGS1(a) {a, FLAG_NONE, FLAG_NONE, FLAG_NONE}
+#define FLAGS2(a, b) {a, b, FLAG_NONE, FLAG_NONE}
+
+// Sorted by capability ID
+const Capabilities::Rule Capabilities::RULES[] PROGMEM = {
+  {CAPABILITY_INDOOR_HUMIDITY, FLAGS1(INDOOR_HUMIDITY), {0, 1}, 2, true},
+  {CAPABILITY_SILKY_COOL, FLAGS1(SILKY_COOL), {0, 1}, 2, true},
+  {CAPABILITY_SMART_EYE, FLAGS1(SMART_EYE), {0, 1, 0}, 3, true},
+  {CAPABILITY_WIND_ON_ME, FLAGS1(WIND_ON_ME), {0, 1, 0}, 3, true},
+  {CAPABILITY_WIND_OF_ME, FLAGS1(WIND_OF_ME), {0, 1, 0}, 3, true},
+  {CAPABILITY_ACTIVE_CLEAN, FLAGS1(ACTIVE_CLEAN), {0, 1, 0}, 3, true},
+  {CAPABILITY_ONE_KEY_NO_WIND_ON_ME, FLAGS1(ONE_KEY_NO_WIND_ON_ME), {0, 1, 0}, 3, true},
+  {CAPABILITY_BREEZE_CONTROL, FLAGS1(BREEZE_CONTROL), {0, 1, 0}, 3, true},
+  {CAPABILITY_FAN_SPEED_CONTROL, FLAGS1(FAN_SPEED_CONTROL), {1, 0, 1}, 3, true},
+  {CAPABILITY_PRESET_ECO, FLAGS2(ECO_MODE, SPECIAL_ECO), {0b00, 0b01, 0b10, 0b00}, 4, true},
+  {CAPABILITY_PRESET_FREEZE_PROTECTION, FLAGS1(FROST_PROTECTION_MODE), {0, 1, 0}, 3, true},
+  {CAPABILITY_MODES, {COOL_MODE, DRY_MODE, AUTO_MODE, HEAT_MODE}, {0b0111, 0b1111, 0b1100, 0b0001}, 4, false},
+  {CAPABILITY_SWING_MODES, FLAGS2(UPDOWN_FAN, LEFTRIGHT_FAN), {0b01, 0b11, 0b00, 0b10}, 4, false},
+  {CAPABILITY_POWER, FLAGS2(POWER_CAL, POWER_CAL_SETTING), {0b00, 0b00, 0b01, 0b11}, 4, false},
+  {CAPABILITY_NEST, FLAGS2(NEST_CHECK, NEST_NEED_CHANGE), {0b00, 0b01, 0b01, 0b10, 0b11}, 5, false},
+  {CAPABILITY_AUX_ELECTRIC_HEATING, FLAGS1(ELECTRIC_AUX_HEATING), {0, 1}, 2, true},
+  {CAPABILITY_PRESET_TURBO, FLAGS2(TURBO_COOL, TURBO_HEAT), {0b01, 0b11, 0b00, 0b10}, 4, false},
+  {CAPABILITY_HUMIDITY, FLAGS2(AUTO_SET_HUMIDITY, MANUAL_SET_HUMIDITY), {0b00, 0b01, 0b11, 0b10}, 4, false},
+  {CAPABILITY_UNIT_CHANGEABLE, FLAGS1(UNIT_CHANGEABLE), {1, 0}, 2, true},
+  {CAPABILITY_LIGHT_CONTROL, FLAGS1(LIGHT_CONTROL), {0, 1}, 2, true},
+  {CAPABILITY_BUZZER, FLAGS1(BUZZER), {0, 1}, 2, true},
+};
+
+void Capabilities::m_apply(uint16_t id, uint8_t value) {
+  const uint8_t num = sizeof(RULES) / sizeof(RULES[0]);
+  uint8_t lo = 0, hi = num;
+  while (lo < hi) {
+    const uint8_t mid = (lo + hi) / 2;
+    if (pgm_read_word(&RULES[mid].id) < id)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo == num || pgm_read_word(&RULES[lo].id) != id)
+    return;
+  Rule rule;
+  memcpy_P(&rule, &RULES[lo], sizeof(rule));
+  if (value >= rule.num) {
+    if (!rule.saturate)
+      return;
+    value = rule.num - 1;
+  }
+  const uint8_t pattern = rule.patterns[value];
+  for (uint8_t n = 0; n < 4 && rule.flags[n] != FLAG_NONE; ++n) {
+    if (pattern & (1 << n))
+      this->m_flags |= 1UL << rule.flags[n];
+    else
+      this->m_flags &= ~(1UL << rule.flags[n]);
+  }
+}
+
+static uint8_t lowerBound(const uint16_t *ids, uint8_t num, uint16_t id) {
+  return std::lower_bound(ids, ids + num, id) - ids;
+}
+
+uint8_t Capabilities::m_find(uint16_t id) const {
+  const uint8_t idx = lowerBound(this->m_ids, this->m_num, id);
+  return (idx < this->m_num && this->m_ids[idx] == id) ? idx : this->m_num;
+}
+
+void Capabilities::m_store(uint16_t id, uint8_t value) {
+  const uint8_t idx = lowerBound(this->m_ids, this->m_num, id);
+  if (idx < this->m_num && this->m_ids[idx] == id) {
+    this->m_values[idx] = value;
+    return;
+  }
+  if (this->m_num >= MAX_CAPABILITIES) {
+    LOG_W(TAG, "No room to store capability 0x%04X.", id);
+    return;
+  }
+  std::copy_backward(this->m_ids + idx, this->m_ids + this->m_num, this->m_ids + this->m_num + 1);
+  std::copy_backward(this->m_values + idx, this->m_values + this->m_num, this->m_values + this->m_num + 1);
+  this->m_ids[idx] = id;
+  this->m_values[idx] = value;
+  ++this->m_num;
+}
+
+uint8_t Capabilities::raw(CapabilityID id) const {
+  const uint8_t idx = this->m_find(id);
+  return (idx < this->m_num) ? this->m_values[idx] : 0;
+}
+
+bool Capabilities::operator==(const Capabilities &other) const {
+  return this->m_flags == other.m_flags && this->m_num == other.m_num &&
+         std::equal(this->m_temps, this->m_temps + sizeof(this->m_temps), other.m_temps) &&
+         std::equal(this->m_ids, this->m_ids + this->m_num, other.m_ids) &&
+         std::equal(this->m_values, this->m_values + this->m_num, other.m_values);
+}
+
+uint32_t Capabilities::fingerprint() const {
+  uint32_t hash = fnv1a(this->m_temps, sizeof(this->m_temps));
+  for (uint8_t n = 0; n < this->m_num; ++n) {
+    const uint8_t entry[] = {static_cast<uint8_t>(this->m_ids[n]), static_cast<uint8_t>(this->m_ids[n] >> 8), this->m_values[n]};
+    hash = fnv1a(entry, sizeof(entry), hash);
+  }
+  return hash;
+}
+
+static const uint8_t SERIALIZED_MAGIC[] = {'M', 'C'};
+static const uint8_t SERIALIZED_VERSION = 1;
+
+size_t Capabilities::serialize(uint8_t *data, size_t size, uint32_t tag) const {
+  const size_t length = SERIALIZED_SIZE - 3 * (MAX_CAPABILITIES - this->m_num);
+  if (size < length)
+    return 0;
+  uint8_t *it = std::copy(SERIALIZED_MAGIC, SERIALIZED_MAGIC + sizeof(SERIALIZED_MAGIC), data);
+  *it++ = SERIALIZED_VERSION;
+  it = putU32(it, tag);
+  it = putU32(it, this->m_flags);
+  it = std::copy(this->m_temps, this->m_temps + sizeof(this->m_temps), it);
+  *it++ = this->m_num;
+  for (uint8_t n = 0; n < this->m_num; ++n) {
+    *it++ = this->m_ids[n];
+    *it++ = this->m_ids[n] >> 8;
+    *it++ = this->m_values[n];
+  }
+  putU32(it, fnv1a(data, it - data));
+  return length;
+}
+
+bool Capabilities::deserialize(const uint8_t *data, size_t size, uint32_t &tag) {
+  const size_t minSize = SERIALIZED_SIZE - 3 * MAX_CAPABILITIES;
+  if (size < minSize || !std::equal(SERIALIZED_MAGIC, SERIALIZED_MAGIC + sizeof(SERIALIZED_MAGIC), data) ||
+      data[2] != SERIALIZED_VERSION)
+    return false;
+  const uint8_t num = data[17];
+  const size_t length = minSize + 3 * num;
+  if (num > MAX_CAPABILITIES || size < length || getU32(data + length - 4) != fnv1a(data, length - 4))
+    return false;
+  tag = getU32(data + 3);
+  this->m_flags = getU32(data + 7);
+  std::copy(data + 11, data + 17, this->m_temps);
+  this->m_num = num;
+  const uint8_t *it = data + 18;
+  for (uint8_t n = 0; n < num; ++n, it += 3) {
+    this->m_ids[n] = read_u16(it);
+    this->m_values[n] = it[2];
+  }
+  return true;
+}
+
 bool Capabilities::read(const FrameData &frame) {
   if (frame.size() < 14)
     return false;
@@ -75,192 +210,20 @@ bool Capabilities::read(const FrameData &frame) {
   for (; cap.isValid(); cap.advance()) {
     if (!cap.size())
       continue;
-    const uint8_t uval = cap[0];
-    const bool bval = uval;
-    switch (cap.id()) {
-      case CAPABILITY_INDOOR_HUMIDITY:
-        this->m_indoorHumidity = bval;
-        break;
-      case CAPABILITY_SILKY_COOL:
-        this->m_silkyCool = bval;
-        break;
-      case CAPABILITY_SMART_EYE:
-        this->m_smartEye = uval == 1;
-        break;
-      case CAPABILITY_WIND_ON_ME:
-        this->m_windOnMe = uval == 1;
-        break;
-      case CAPABILITY_WIND_OF_ME:
-        this->m_windOfMe = uval == 1;
-        break;
-      case CAPABILITY_ACTIVE_CLEAN:
-        this->m_activeClean = uval == 1;
-        break;
-      case CAPABILITY_ONE_KEY_NO_WIND_ON_ME:
-        this->m_oneKeyNoWindOnMe = uval == 1;
-        break;
-      case CAPABILITY_BREEZE_CONTROL:
-        this->m_breezeControl = uval == 1;
-        break;
-      case CAPABILITY_FAN_SPEED_CONTROL:
-        this->m_fanSpeedControl = uval != 1;
-        break;
-      case CAPABILITY_PRESET_ECO:
-        this->m_ecoMode = uval == 1;
-        this->m_specialEco = uval == 2;
-        break;
-      case CAPABILITY_PRESET_FREEZE_PROTECTION:
-        this->m_frostProtectionMode = uval == 1;
-        break;
-      case CAPABILITY_MODES:
-        switch (uval) {
-          case 0:
-            this->m_heatMode = false;
-            this->m_coolMode = true;
-            this->m_dryMode = true;
-            this->m_autoMode = true;
-            break;
-          case 1:
-            this->m_coolMode = true;
-            this->m_heatMode= true;
-            this->m_dryMode = true;
-            this->m_autoMode = true;
-            break;
-          case 2:
-            this->m_coolMode = false;
-            this->m_dryMode = false;
-            this->m_heatMode = true;
-            this->m_autoMode = true;
-            break;
-          case 3:
-            this->m_coolMode = true;
-            this->m_dryMode = false;
-            this->m_heatMode = false;
-            this->m_autoMode = false;
-            break;
-        }
-        break;
-      case CAPABILITY_SWING_MODES:
-        switch (uval) {
-          case 0:
-            this->m_leftrightFan = false;
-            this->m_updownFan = true;
-            break;
-          case 1:
-            this->m_leftrightFan = true;
-            this->m_updownFan = true;
-            break;
-          case 2:
-            this->m_leftrightFan = false;
-            this->m_updownFan = false;
-            break;
-          case 3:
-            this->m_leftrightFan = true;
-            this->m_updownFan = false;
-            break;
-        }
-        break;
-      case CAPABILITY_POWER:
-        switch (uval) {
-          case 0:
-          case 1:
-            this->m_powerCal = false;
-            this->m_powerCalSetting = false;
-            break;
-          case 2:
-            this->m_powerCal = true;
-            this->m_powerCalSetting = false;
-            break;
-          case 3:
-            this->m_powerCal = true;
-            this->m_powerCalSetting = true;
-            break;
-        }
-        break;
-      case CAPABILITY_NEST:
-        switch (uval) {
-          case 0:
-            this->m_nestCheck = false;
-            this->m_nestNeedChange = false;
-            break;
-          case 1:
-          case 2:
-            this->m_nestCheck = true;
-            this->m_nestNeedChange = false;
-            break;
-          case 3:
-            this->m_nestCheck = false;
-            this->m_nestNeedChange = true;
-            break;
-          case 4:
-            this->m_nestCheck = true;
-            this->m_nestNeedChange = true;
-            break;
-        }
-        break;
-      case CAPABILITY_AUX_ELECTRIC_HEATING:
-        this->m_electricAuxHeating = bval;
-        break;
-      case CAPABILITY_PRESET_TURBO:
-        switch (uval) {
-          case 0:
-            this->m_turboHeat = false;
-            this->m_turboCool = true;
-            break;
-          case 1:
-            this->m_turboHeat = true;
-            this->m_turboCool = true;
-            break;
-          case 2:
-            this->m_turboHeat = false;
-            this->m_turboCool = false;
-            break;
-           case 3:
-            this->m_turboHeat = true;
-            this->m_turboCool = false;
-            break;
-        }
-        break;
-      case CAPABILITY_HUMIDITY:
-        switch (uval) {
-          case 0:
-            this->m_autoSetHumidity = false;
-            this->m_manualSetHumidity = false;
-            break;
-          case 1:
-            this->m_autoSetHumidity = true;
-            this->m_manualSetHumidity = false;
-            break;
-          case 2:
-            this->m_autoSetHumidity = true;
-            this->m_manualSetHumidity = true;
-            break;
-          case 3:
-            this->m_autoSetHumidity = false;
-            this->m_manualSetHumidity = true;
-            break;
-        }
-        break;
-      case CAPABILITY_UNIT_CHANGEABLE:
-        this->m_unitChangeable = !bval;
-        break;
-      case CAPABILITY_LIGHT_CONTROL:
-        this->m_lightControl = bval;
-        break;
-      case CAPABILITY_TEMPERATURES:
-        if (cap.size() >= 6) {
-          this->m_minTempCool = static_cast<float>(uval) * 0.5f;
-          this->m_maxTempCool = static_cast<float>(cap[1]) * 0.5f;
-          this->m_minTempAuto = static_cast<float>(cap[2]) * 0.5f;
-          this->m_maxTempAuto = static_cast<float>(cap[3]) * 0.5f;
-          this->m_minTempHeat = static_cast<float>(cap[4]) * 0.5f;
-          this->m_maxTempHeat = static_cast<float>(cap[5]) * 0.5f;
-          this->m_decimals = (cap.size() > 6) ? cap[6] : cap[2];
-        }
-        break;
-      case CAPABILITY_BUZZER:
-        this->m_buzzer = bval;
-        break;
+    const uint16_t id = cap.id();
+    this->m_store(id, cap[0]);
+    if (id != CAPABILITY_TEMPERATURES) {
+      this->m_apply(id, cap[0]);
+      continue;
+    }
+    if (cap.size() >= 6) {
+      for (uint8_t n = 0; n < sizeof(this->m_temps); ++n)
+        this->m_temps[n] = cap[n];
+      const bool decimals = (cap.size() > 6) ? cap[6] : cap[2];
+      if (decimals)
+        this->m_flags |= 1UL << DECIMALS;
+      else
+        this->m_flags &= ~(1UL << DECIMALS);
     }
   }
 
@@ -277,49 +240,49 @@ bool Capabilities::read(const FrameData &frame) {
 
 void Capabilities::dump() const {
   LOG_CONFIG(TAG, "CAPABILITIES REPORT:");
-  if (this->m_autoMode) {
+  if (this->supportAutoMode()) {
     LOG_CONFIG(TAG, "  [x] AUTO MODE");
-    LOG_CONFIG(TAG, "      - MIN TEMP: %.1f", this->m_minTempAuto);
-    LOG_CONFIG(TAG, "      - MAX TEMP: %.1f", this->m_maxTempAuto);
+    LOG_CONFIG(TAG, "      - MIN TEMP: %.1f", this->minTempAuto());
+    LOG_CONFIG(TAG, "      - MAX TEMP: %.1f", this->maxTempAuto());
   }
-  if (this->m_coolMode) {
+  if (this->supportCoolMode()) {
     LOG_CONFIG(TAG, "  [x] COOL MODE");
-    LOG_CONFIG(TAG, "      - MIN TEMP: %.1f", this->m_minTempCool);
-    LOG_CONFIG(TAG, "      - MAX TEMP: %.1f", this->m_maxTempCool);
+    LOG_CONFIG(TAG, "      - MIN TEMP: %.1f", this->minTempCool());
+    LOG_CONFIG(TAG, "      - MAX TEMP: %.1f", this->maxTempCool());
   }
-  if (this->m_heatMode) {
+  if (this->supportHeatMode()) {
     LOG_CONFIG(TAG, "  [x] HEAT MODE");
-    LOG_CONFIG(TAG, "      - MIN TEMP: %.1f", this->m_minTempHeat);
-    LOG_CONFIG(TAG, "      - MAX TEMP: %.1f", this->m_maxTempHeat);
+    LOG_CONFIG(TAG, "      - MIN TEMP: %.1f", this->minTempHeat());
+    LOG_CONFIG(TAG, "      - MAX TEMP: %.1f", this->maxTempHeat());
   }
-  LOG_CAPABILITY("  [x] DRY MODE", this->m_dryMode);
-  LOG_CAPABILITY("  [x] ECO MODE", this->m_ecoMode);
-  LOG_CAPABILITY("  [x] SPECIAL ECO", this->m_specialEco);
-  LOG_CAPABILITY("  [x] FROST PROTECTION MODE", this->m_frostProtectionMode);
-  LOG_CAPABILITY("  [x] TURBO COOL", this->m_turboCool);
-  LOG_CAPABILITY("  [x] TURBO HEAT", this->m_turboHeat);
-  LOG_CAPABILITY("  [x] FANSPEED CONTROL", this->m_fanSpeedControl);
-  LOG_CAPABILITY("  [x] BREEZE CONTROL", this->m_breezeControl);
-  LOG_CAPABILITY("  [x] LIGHT CONTROL", this->m_lightControl);
-  LOG_CAPABILITY("  [x] UPDOWN FAN", this->m_updownFan);
-  LOG_CAPABILITY("  [x] LEFTRIGHT FAN", this->m_leftrightFan);
-  LOG_CAPABILITY("  [x] AUTO SET HUMIDITY", this->m_autoSetHumidity);
-  LOG_CAPABILITY("  [x] MANUAL SET HUMIDITY", this->m_manualSetHumidity);
-  LOG_CAPABILITY("  [x] INDOOR HUMIDITY", this->m_indoorHumidity);
-  LOG_CAPABILITY("  [x] POWER CAL", this->m_powerCal);
-  LOG_CAPABILITY("  [x] POWER CAL SETTING", this->m_powerCalSetting);
-  LOG_CAPABILITY("  [x] BUZZER", this->m_buzzer);
-  LOG_CAPABILITY("  [x] ACTIVE CLEAN", this->m_activeClean);
-  LOG_CAPABILITY("  [x] DECIMALS", this->m_decimals);
-  LOG_CAPABILITY("  [x] ELECTRIC AUX HEATING", this->m_electricAuxHeating);
-  LOG_CAPABILITY("  [x] NEST CHECK", this->m_nestCheck);
-  LOG_CAPABILITY("  [x] NEST NEED CHANGE", this->m_nestNeedChange);
-  LOG_CAPABILITY("  [x] ONE KEY NO WIND ON ME", this->m_oneKeyNoWindOnMe);
-  LOG_CAPABILITY("  [x] SILKY COOL", this->m_silkyCool);
-  LOG_CAPABILITY("  [x] SMART EYE", this->m_smartEye);
-  LOG_CAPABILITY("  [x] UNIT CHANGEABLE", this->m_unitChangeable);
-  LOG_CAPABILITY("  [x] WIND OF ME", this->m_windOfMe);
-  LOG_CAPABILITY("  [x] WIND ON ME", this->m_windOnMe);
+  LOG_CAPABILITY("  [x] DRY MODE", this->supportDryMode());
+  LOG_CAPABILITY("  [x] ECO MODE", this->m_get(ECO_MODE));
+  LOG_CAPABILITY("  [x] SPECIAL ECO", this->m_get(SPECIAL_ECO));
+  LOG_CAPABILITY("  [x] FROST PROTECTION MODE", this->supportFrostProtectionPreset());
+  LOG_CAPABILITY("  [x] TURBO COOL", this->m_get(TURBO_COOL));
+  LOG_CAPABILITY("  [x] TURBO HEAT", this->m_get(TURBO_HEAT));
+  LOG_CAPABILITY("  [x] FANSPEED CONTROL", this->fanSpeedControl());
+  LOG_CAPABILITY("  [x] BREEZE CONTROL", this->breezeControl());
+  LOG_CAPABILITY("  [x] LIGHT CONTROL", this->supportLightControl());
+  LOG_CAPABILITY("  [x] UPDOWN FAN", this->supportVerticalSwing());
+  LOG_CAPABILITY("  [x] LEFTRIGHT FAN", this->supportHorizontalSwing());
+  LOG_CAPABILITY("  [x] AUTO SET HUMIDITY", this->autoSetHumidity());
+  LOG_CAPABILITY("  [x] MANUAL SET HUMIDITY", this->manualSetHumidity());
+  LOG_CAPABILITY("  [x] INDOOR HUMIDITY", this->indoorHumidity());
+  LOG_CAPABILITY("  [x] POWER CAL", this->powerCal());
+  LOG_CAPABILITY("  [x] POWER CAL SETTING", this->powerCalSetting());
+  LOG_CAPABILITY("  [x] BUZZER", this->buzzer());
+  LOG_CAPABILITY("  [x] ACTIVE CLEAN", this->activeClean());
+  LOG_CAPABILITY("  [x] DECIMALS", this->decimals());
+  LOG_CAPABILITY("  [x] ELECTRIC AUX HEATING", this->electricAuxHeating());
+  LOG_CAPABILITY("  [x] NEST CHECK", this->nestCheck());
+  LOG_CAPABILITY("  [x] NEST NEED CHANGE", this->nestNeedChange());
+  LOG_CAPABILITY("  [x] ONE KEY NO WIND ON ME", this->oneKeyNoWindOnMe());
+  LOG_CAPABILITY("  [x] SILKY COOL", this->silkyCool());
+  LOG_CAPABILITY("  [x] SMART EYE", this->smartEye());
+  LOG_CAPABILITY("  [x] UNIT CHANGEABLE", this->unitChangeable());
+  LOG_CAPABILITY("  [x] WIND OF ME", this->windOfMe());
+  LOG_CAPABILITY("  [x] WIND ON ME", this->windOnMe());
 }
 
 }  // namespace ac
@@ -0,0 +1,146 @@
+#include "Appliance/AirConditioner/EnergyMeter.h"
+#include "Helpers/Helpers.h"
+#include "Helpers/Log.h"
+#include <algorithm>
+
+namespace dudanov {
+namespace midea {
+namespace ac {
+
+static const char *TAG = "EnergyMeter";
+static const uint8_t SERIALIZED_MAGIC[] = {'M', 'E'};
+static const uint8_t SERIALIZED_VERSION = 1;
+
+void EnergyMeter::addSample(uint32_t time, uint32_t counter) {
+  if (!this->m_hasSample) {
+    this->m_hasSample = true;
+    this->m_bucketStart = time - time % BUCKET_TIME;
+    this->m_lastTime = time;
+    this->m_lastCounter = counter;
+    return;
+  }
+  uint32_t delta = 0;
+  if (counter >= this->m_lastCounter) {
+    delta = counter - this->m_lastCounter;
+  } else if (this->m_lastCounter - counter > COUNTER_MODULO / 2) {
+    // BCD counter wraparound
+    delta = counter + COUNTER_MODULO - this->m_lastCounter;
+  } else {
+    LOG_W(TAG, "Energy counter went back from %u to %u. Appliance reset? New baseline is used.",
+          static_cast<unsigned>(this->m_lastCounter), static_cast<unsigned>(counter));
+  }
+  const uint32_t begin = this->m_lastTime;
+  this->m_lastTime = time;
+  this->m_lastCounter = counter;
+  if (!this->m_advance(time)) {
+    // Clock restarted: interval is unknown
+    this->m_add(0, delta * 100);
+    return;
+  }
+  this->m_spread(delta * 100, begin, time);
+}
+
+bool EnergyMeter::m_advance(uint32_t time) {
+  if (time < this->m_bucketStart) {
+    this->m_bucketStart = time - time % BUCKET_TIME;
+    return false;
+  }
+  const uint32_t hours = (time - this->m_bucketStart) / BUCKET_TIME;
+  for (uint32_t n = std::min<uint32_t>(hours, NUM_BUCKETS); n; --n) {
+    this->m_head = (this->m_head + 1) % NUM_BUCKETS;
+    this->m_buckets[this->m_head] = 0;
+  }
+  this->m_bucketStart += hours * BUCKET_TIME;
+  return true;
+}
+
+void EnergyMeter::m_spread(uint32_t energy, uint32_t begin, uint32_t end) {
+  if (!energy)
+    return;
+  if (begin >= end || end - begin <= end - this->m_bucketStart) {
+    this->m_add(0, energy);
+    return;
+  }
+  // Cumulative share of each bucket is rounded, so sum of shares is exactly `energy`
+  const uint64_t duration = end - begin;
+  uint32_t spent = 0;
+  uint32_t bucketEnd = end;
+  uint32_t bucketStart = this->m_bucketStart;
+  // Long gap (e.g. clock set from 1970) costs no more than number of buckets
+  for (uint32_t hoursAgo = 0; bucketEnd > begin && hoursAgo < NUM_BUCKETS; ++hoursAgo) {
+    const uint32_t from = std::max(bucketStart, begin);
+    const uint32_t share = static_cast<uint32_t>(energy * static_cast<uint64_t>(end - from) / duration) - spent;
+    spent += share;
+    this->m_add(hoursAgo, share);
+    bucketEnd = bucketStart;
+    bucketStart -= BUCKET_TIME;
+  }
+  // Rest is older than oldest bucket
+  this->m_total += energy - spent;
+}
+
+void EnergyMeter::m_add(uint8_t hoursAgo, uint32_t energy) {
+  uint16_t &bucket = this->m_bucket(hoursAgo);
+  bucket = std::min<uint32_t>(bucket + energy, UINT16_MAX);
+  this->m_total += energy;
+}
+
+uint16_t EnergyMeter::getHour(uint8_t hoursAgo) const {
+  if (hoursAgo >= NUM_BUCKETS)
+    return 0;
+  return this->m_buckets[(this->m_head + NUM_BUCKETS - hoursAgo) % NUM_BUCKETS];
+}
+
+uint32_t EnergyMeter::getLastHours(uint8_t hours) const {
+  uint32_t energy = 0;
+  for (uint8_t n = 0; n < hours && n < NUM_BUCKETS; ++n)
+    energy += this->getHour(n);
+  return energy;
+}
+
+uint8_t EnergyMeter::exportHours(uint16_t *data, uint8_t size) const {
+  const uint8_t num = (size < NUM_BUCKETS) ? size : NUM_BUCKETS;
+  for (uint8_t n = 0; n < num; ++n)
+    data[n] = this->getHour(num - 1 - n);
+  return num;
+}
+
+size_t EnergyMeter::serialize(uint8_t *data, size_t size) const {
+  if (size < SERIALIZED_SIZE)
+    return 0;
+  uint8_t *it = std::copy(SERIALIZED_MAGIC, SERIALIZED_MAGIC + sizeof(SERIALIZED_MAGIC), data);
+  *it++ = SERIALIZED_VERSION;
+  it = putU32(it, this->m_bucketStart);
+  it = putU32(it, this->m_lastTime);
+  it = putU32(it, this->m_lastCounter);
+  it = putU32(it, this->m_total);
+  *it++ = this->m_hasSample;
+  // Buckets from oldest to current
+  for (uint8_t n = NUM_BUCKETS; n--;) {
+    const uint16_t value = this->getHour(n);
+    *it++ = value;
+    *it++ = value >> 8;
+  }
+  putU32(it, fnv1a(data, it - data));
+  return SERIALIZED_SIZE;
+}
+
+bool EnergyMeter::deserialize(const uint8_t *data, size_t size) {
+  if (size < SERIALIZED_SIZE || !std::equal(SERIALIZED_MAGIC, SERIALIZED_MAGIC + sizeof(SERIALIZED_MAGIC), data) ||
+      data[2] != SERIALIZED_VERSION || getU32(data + SERIALIZED_SIZE - 4) != fnv1a(data, SERIALIZED_SIZE - 4))
+    return false;
+  this->m_bucketStart = getU32(data + 3);
+  this->m_lastTime = getU32(data + 7);
+  this->m_lastCounter = getU32(data + 11);
+  this->m_total = getU32(data + 15);
+  this->m_hasSample = data[19];
+  const uint8_t *it = data + 20;
+  for (uint8_t n = 0; n < NUM_BUCKETS; ++n, it += 2)
+    this->m_buckets[n] = it[0] | (it[1] << 8);
+  this->m_head = NUM_BUCKETS - 1;
+  return true;
+}
+
+}  // namespace ac
+}  // namespace midea
+}  // namespace dudanov
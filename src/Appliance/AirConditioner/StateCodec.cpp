@@ -0,0 +1,161 @@
+#include "Appliance/AirConditioner/StateCodec.h"
+#include "Helpers/Helpers.h"
+#include <cstring>
+
+namespace dudanov {
+namespace midea {
+namespace ac {
+
+static uint8_t *putField(uint8_t *it, uint8_t id, uint32_t value) {
+  *it++ = id;
+  return putVarint(it, value);
+}
+
+// Copy encoded message to caller buffer
+static size_t output(const uint8_t *message, const uint8_t *end, uint8_t *data, size_t size) {
+  const size_t length = end - message;
+  if (size < length)
+    return 0;
+  std::memcpy(data, message, length);
+  return length;
+}
+
+size_t StateCodec::encode(const AcState &state, uint8_t *data, size_t size) {
+  return m_encodeState(state, nullptr, data, size);
+}
+
+size_t StateCodec::encodeDelta(const AcState &state, const AcState &prev, uint8_t *data, size_t size) {
+  return m_encodeState(state, &prev, data, size);
+}
+
+size_t StateCodec::m_encodeState(const AcState &state, const AcState *prev, uint8_t *data, size_t size) {
+  // Full snapshot has all fields changed
+  const uint16_t mask = (prev != nullptr) ? state.diff(*prev) : UINT16_MAX;
+  uint8_t message[MAX_STATE_SIZE];
+  uint8_t *it = message;
+  *it++ = (prev != nullptr) ? MESSAGE_DELTA : MESSAGE_STATE;
+  it = putField(it, FIELD_SEQUENCE, state.sequence);
+  if (prev != nullptr)
+    it = putField(it, FIELD_BASE_SEQUENCE, prev->sequence);
+  if (mask & CHANGE_MODE)
+    it = putField(it, FIELD_MODE, state.mode);
+  if (mask & CHANGE_PRESET)
+    it = putField(it, FIELD_PRESET, state.preset);
+  if (mask & CHANGE_FAN_MODE)
+    it = putField(it, FIELD_FAN_MODE, state.fanMode);
+  if (mask & CHANGE_SWING_MODE)
+    it = putField(it, FIELD_SWING_MODE, state.swingMode);
+  if (mask & CHANGE_TARGET_TEMP)
+    it = putField(it, FIELD_TARGET_TEMP, zigzag(state.targetTemp));
+  if (mask & CHANGE_INDOOR_TEMP)
+    it = putField(it, FIELD_INDOOR_TEMP, zigzag(state.indoorTemp));
+  if (mask & CHANGE_OUTDOOR_TEMP)
+    it = putField(it, FIELD_OUTDOOR_TEMP, zigzag(state.outdoorTemp));
+  if (mask & CHANGE_HUMIDITY_SETPOINT)
+    it = putField(it, FIELD_HUMIDITY_SETPOINT, state.humiditySetpoint);
+  if (mask & CHANGE_POWER_USAGE)
+    it = putField(it, FIELD_POWER_USAGE, state.powerUsage);
+  return output(message, it, data, size);
+}
+
+size_t StateCodec::encode(const Capabilities &capabilities, uint8_t *data, size_t size) {
+  uint8_t message[MAX_CAPABILITIES_SIZE];
+  uint8_t *it = message;
+  *it++ = MESSAGE_CAPABILITIES;
+  it = putField(it, FIELD_FLAGS, capabilities.m_flags);
+  for (uint8_t n = 0; n < sizeof(capabilities.m_temps); ++n)
+    it = putField(it, FIELD_TEMP_FIRST + n, capabilities.m_temps[n]);
+  for (uint8_t n = 0; n < capabilities.m_num; ++n)
+    it = putField(it, FIELD_CAPABILITY, static_cast<uint32_t>(capabilities.m_ids[n]) << 8 | capabilities.m_values[n]);
+  return output(message, it, data, size);
+}
+
+bool StateCodec::decode(const uint8_t *data, size_t size, AcState &state) {
+  if (!size || (data[0] != MESSAGE_STATE && data[0] != MESSAGE_DELTA))
+    return false;
+  const uint8_t *const end = data + size;
+  // Fields are applied to copy, so corrupted message leaves state intact
+  AcState result = (data[0] == MESSAGE_DELTA) ? state : AcState{};
+  bool hasBase = false;
+  for (const uint8_t *it = data + 1; it < end;) {
+    const uint8_t id = *it++;
+    uint32_t value;
+    if ((it = getVarint(it, end, value)) == nullptr)
+      return false;
+    switch (id) {
+      case FIELD_SEQUENCE:
+        result.sequence = value;
+        break;
+      case FIELD_BASE_SEQUENCE:
+        hasBase = value == state.sequence;
+        break;
+      case FIELD_MODE:
+        result.mode = static_cast<Mode>(value);
+        break;
+      case FIELD_PRESET:
+        result.preset = static_cast<Preset>(value);
+        break;
+      case FIELD_FAN_MODE:
+        result.fanMode = static_cast<FanMode>(value);
+        break;
+      case FIELD_SWING_MODE:
+        result.swingMode = static_cast<SwingMode>(value);
+        break;
+      case FIELD_TARGET_TEMP:
+        result.targetTemp = unzigzag(value);
+        break;
+      case FIELD_INDOOR_TEMP:
+        result.indoorTemp = unzigzag(value);
+        break;
+      case FIELD_OUTDOOR_TEMP:
+        result.outdoorTemp = unzigzag(value);
+        break;
+      case FIELD_HUMIDITY_SETPOINT:
+        result.humiditySetpoint = value;
+        break;
+      case FIELD_POWER_USAGE:
+        result.powerUsage = value;
+        break;
+      default:
+        // Field of newer schema
+        break;
+    }
+  }
+  if (data[0] == MESSAGE_DELTA && !hasBase)
+    return false;
+  result.timestamp = state.timestamp;
+  result.changeMask = result.diff(state);
+  state = result;
+  return true;
+}
+
+bool StateCodec::decode(const uint8_t *data, size_t size, Capabilities &capabilities) {
+  if (!size || data[0] != MESSAGE_CAPABILITIES)
+    return false;
+  const uint8_t *const end = data + size;
+  Capabilities result;
+  result.m_num = 0;
+  for (const uint8_t *it = data + 1; it < end;) {
+    const uint8_t id = *it++;
+    uint32_t value;
+    if ((it = getVarint(it, end, value)) == nullptr)
+      return false;
+    if (id == FIELD_FLAGS) {
+      result.m_flags = value;
+    } else if (id >= FIELD_TEMP_FIRST && id < FIELD_TEMP_FIRST + sizeof(result.m_temps)) {
+      result.m_temps[id - FIELD_TEMP_FIRST] = value;
+    } else if (id == FIELD_CAPABILITY) {
+      // IDs are sorted for binary search
+      if (result.m_num >= Capabilities::MAX_CAPABILITIES || (result.m_num && result.m_ids[result.m_num - 1] >= value >> 8))
+        return false;
+      result.m_ids[result.m_num] = value >> 8;
+      result.m_values[result.m_num++] = value;
+    }
+  }
+  capabilities = result;
+  return true;
+}
+
+}  // namespace ac
+}  // namespace midea
+}  // namespace dudanov
@@ -1,56 +1,66 @@
 #include "Appliance/AirConditioner/StatusData.h"
+#include "Appliance/AirConditioner/AcState.h"
 
 namespace dudanov {
 namespace midea {
 namespace ac {
 
-float StatusData::getTargetTemp() const {
-  uint8_t tmp = this->m_getValue(2, 15) + 16;
-  uint8_t tmpNew = this->m_getValue(13, 31);
-  if (tmpNew)
-    tmp = tmpNew + 12;
-  float temp = static_cast<float>(tmp);
-  if (this->m_getValue(2, 16))
-    temp += 0.5F;
+using Layout = StatusLayout;
+
+static int16_t decodeTargetTemp(uint8_t integer, uint8_t integerNew, bool half) {
+  uint8_t tmp = integer + 16;
+  if (integerNew)
+    tmp = integerNew + 12;
+  int16_t temp = tmp * 10;
+  if (half)
+    temp += 5;
   return temp;
 }
 
-void StatusData::setTargetTemp(float temp) {
-  uint8_t tmp = static_cast<uint8_t>(temp * 4.0F) + 1;
+int16_t StatusData::getTargetTempTenths() const {
+  return decodeTargetTemp(this->m_get<Layout::TargetTemp>(), this->m_get<Layout::TargetTempNew>(),
+                       this->m_get<Layout::TargetTempHalf>());
+}
+
+void StatusData::setTargetTempTenths(int16_t temp) {
+  // quarters of degree with rounding to half
+  uint8_t tmp = static_cast<uint8_t>(temp * 2 / 5) + 1;
   uint8_t integer = tmp / 4;
-  this->m_setValue(18, integer - 12, 31);
+  this->m_set<Layout::TargetTempNewSet>(integer - 12);
   integer -= 16;
   if (integer < 1 || integer > 14)
     integer = 1;
-  this->m_setValue(2, ((tmp & 2) << 3) | integer, 31);
+  this->m_set<Layout::TargetTempSet>(((tmp & 2) << 3) | integer);
 }
 
-static float getTemp(int integer, int decimal, bool fahrenheits) {
+static int16_t decodeTemp(int integer, int decimal, bool fahrenheits) {
   integer -= 50;
   if (!fahrenheits && decimal > 0)
-    return static_cast<float>(integer / 2) + static_cast<float>(decimal) * ((integer >= 0) ? 0.1F : -0.1F);
+    return (integer / 2) * 10 + ((integer >= 0) ? decimal : -decimal);
   if (decimal >= 5)
-    return static_cast<float>(integer / 2) + ((integer >= 0) ? 0.5F : -0.5F);
-  return static_cast<float>(integer) * 0.5F;
+    return (integer / 2) * 10 + ((integer >= 0) ? 5 : -5);
+  return integer * 5;
+}
+int16_t StatusData::getIndoorTempTenths() const {
+  return decodeTemp(this->m_get<Layout::IndoorTemp>(), this->m_get<Layout::IndoorTempDecimal>(), this->isFahrenheits());
+}
+int16_t StatusData::getOutdoorTempTenths() const {
+  return decodeTemp(this->m_get<Layout::OutdoorTemp>(), this->m_get<Layout::OutdoorTempDecimal>(), this->isFahrenheits());
 }
-float StatusData::getIndoorTemp() const { return getTemp(this->m_getValue(11), this->m_getValue(15, 15), this->isFahrenheits()); }
-float StatusData::getOutdoorTemp() const { return getTemp(this->m_getValue(12), this->m_getValue(15, 15, 4), this->isFahrenheits()); }
-float StatusData::getHumiditySetpoint() const { return static_cast<float>(this->m_getValue(19, 127)); }
 
 Mode StatusData::getMode() const { return this->m_getPower() ? this->getRawMode() : Mode::MODE_OFF; }
 
 void StatusData::setMode(Mode mode) {
   if (mode != Mode::MODE_OFF) {
     this->m_setPower(true);
-    this->m_setValue(2, mode, 7, 5);
+    this->m_set<Layout::Mode>(mode);
   } else {
     this->m_setPower(false);
   }
 }
 
-FanMode StatusData::getFanMode() const {
+static FanMode decodeFanMode(uint8_t fanMode) {
   //some ACs return 30 for LOW and 50 for MEDIUM. Note though, in appMode, this device still uses 40/60
-  uint8_t fanMode = this->m_getValue(3);
   if (fanMode == 30) {
     fanMode = FAN_LOW;
   } else if (fanMode == 50) {
@@ -59,18 +69,24 @@ FanMode StatusData::getFanMode() const {
   return static_cast<FanMode>(fanMode); 
 }
 
-Preset StatusData::getPreset() const {
-  if (this->m_getEco())
+FanMode StatusData::getFanMode() const { return decodeFanMode(this->m_get<Layout::FanMode>()); }
+
+static Preset decodePreset(bool eco, bool turbo, bool sleep, bool freezeProtection) {
+  if (eco)
     return Preset::PRESET_ECO;
-  if (this->m_getTurbo())
+  if (turbo)
     return Preset::PRESET_TURBO;
-  if (this->m_getSleep())
+  if (sleep)
     return Preset::PRESET_SLEEP;
-  if (this->m_getFreezeProtection())
+  if (freezeProtection)
     return Preset::PRESET_FREEZE_PROTECTION;
   return Preset::PRESET_NONE;
 }
 
+Preset StatusData::getPreset() const {
+  return decodePreset(this->m_getEco(), this->m_getTurbo(), this->m_getSleep(), this->m_getFreezeProtection());
+}
+
 void StatusData::setPreset(Preset preset) {
   this->m_setEco(false);
   this->m_setSleep(false);
@@ -96,15 +112,35 @@ void StatusData::setPreset(Preset preset) {
   }
 }
 
+void StatusData::decodeAll(const uint8_t *data, uint8_t size, AcState &state) {
+  // Short payloads are padded with zeros, so fields are read without bounds checking
+  uint8_t buf[Layout::SIZE]{};
+  if (size < Layout::SIZE) {
+    std::copy(data, data + size, buf);
+    data = buf;
+  }
+  const bool fahrenheits = Layout::Fahrenheits::get(data);
+  state.mode = Layout::Power::get(data) ? static_cast<Mode>(Layout::Mode::get(data)) : Mode::MODE_OFF;
+  state.preset = decodePreset(Layout::Eco::get(data), Layout::Turbo::get(data) || Layout::TurboAlt::get(data),
+                              Layout::Sleep::get(data), Layout::FreezeProtection::get(data));
+  state.fanMode = decodeFanMode(Layout::FanMode::get(data));
+  state.swingMode = static_cast<SwingMode>(Layout::SwingMode::get(data));
+  state.targetTemp = decodeTargetTemp(Layout::TargetTemp::get(data), Layout::TargetTempNew::get(data),
+                                      Layout::TargetTempHalf::get(data));
+  state.indoorTemp = decodeTemp(Layout::IndoorTemp::get(data), Layout::IndoorTempDecimal::get(data), fahrenheits);
+  state.outdoorTemp = decodeTemp(Layout::OutdoorTemp::get(data), Layout::OutdoorTempDecimal::get(data), fahrenheits);
+  state.humiditySetpoint = Layout::HumiditySetpoint::get(data);
+}
+
 static uint8_t bcd2u8(uint8_t bcd) { return 10 * (bcd >> 4) + (bcd & 15); }
 
-float StatusData::getPowerUsage() const {
+uint32_t StatusData::decodePowerUsage(const uint8_t *data) {
   uint32_t power = 0;
-  const uint8_t *ptr = this->m_data.data() + 18;
+  const uint8_t *ptr = data + 18;
   for (uint32_t weight = 1;; weight *= 100, --ptr) {
     power += weight * bcd2u8(*ptr);
     if (weight == 10000)
-      return static_cast<float>(power) * 0.1F;
+      return power;
   }
 }
 
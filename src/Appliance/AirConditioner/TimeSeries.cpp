@@ -0,0 +1,172 @@
+#include "Appliance/AirConditioner/TimeSeries.h"
+#include "Helpers/Helpers.h"
+#include <cstring>
+
+namespace dudanov {
+namespace midea {
+namespace ac {
+
+static const uint8_t SERIALIZED_MAGIC[] = {'M', 'T'};
+static const uint8_t SERIALIZED_VERSION = 1;
+// Maximum size of point delta: flags, time, 3 temperatures and mode
+static const uint8_t MAX_DELTA_SIZE = 1 + 5 + 3 * 3 + 1;
+static const uint16_t INTERVALS[TimeSeries::NUM_TIERS] = {10, 60, 900};
+
+enum PointFlag : uint8_t {
+  FLAG_INDOOR_TEMP = 1 << 0,
+  FLAG_OUTDOOR_TEMP = 1 << 1,
+  FLAG_TARGET_TEMP = 1 << 2,
+  FLAG_MODE = 1 << 3,
+};
+
+uint8_t *SeriesBuffer::m_encode(uint8_t *it, const SeriesPoint &prev, const SeriesPoint &point) {
+  uint8_t *const flags = it++;
+  *flags = 0;
+  // Clock jumped back: time delta is lost
+  it = putVarint(it, (point.time > prev.time) ? point.time - prev.time : 0);
+  if (point.indoorTemp != prev.indoorTemp) {
+    *flags |= FLAG_INDOOR_TEMP;
+    it = putVarint(it, zigzag(point.indoorTemp - prev.indoorTemp));
+  }
+  if (point.outdoorTemp != prev.outdoorTemp) {
+    *flags |= FLAG_OUTDOOR_TEMP;
+    it = putVarint(it, zigzag(point.outdoorTemp - prev.outdoorTemp));
+  }
+  if (point.targetTemp != prev.targetTemp) {
+    *flags |= FLAG_TARGET_TEMP;
+    it = putVarint(it, zigzag(point.targetTemp - prev.targetTemp));
+  }
+  if (point.mode != prev.mode) {
+    *flags |= FLAG_MODE;
+    *it++ = point.mode;
+  }
+  return it;
+}
+
+const uint8_t *SeriesBuffer::decode(const uint8_t *it, const uint8_t *end, SeriesPoint &point) {
+  if (it >= end)
+    return nullptr;
+  const uint8_t flags = *it++;
+  uint32_t value;
+  if ((it = getVarint(it, end, value)) == nullptr)
+    return nullptr;
+  point.time += value;
+  int16_t *const temps[] = {&point.indoorTemp, &point.outdoorTemp, &point.targetTemp};
+  for (uint8_t n = 0; n < 3; ++n) {
+    if (!(flags & (1 << n)))
+      continue;
+    if ((it = getVarint(it, end, value)) == nullptr)
+      return nullptr;
+    *temps[n] += unzigzag(value);
+  }
+  if (flags & FLAG_MODE) {
+    if (it >= end)
+      return nullptr;
+    point.mode = static_cast<Mode>(*it++);
+  }
+  return it;
+}
+
+void SeriesBuffer::add(const SeriesPoint &point) {
+  if (!this->m_num) {
+    this->m_base = this->m_last = point;
+    this->m_num = 1;
+    return;
+  }
+  uint8_t delta[MAX_DELTA_SIZE];
+  const uint16_t size = m_encode(delta, this->m_last, point) - delta;
+  if (this->m_length + size > CAPACITY)
+    this->m_evict(this->m_length + size - CAPACITY);
+  std::memcpy(this->m_data + this->m_length, delta, size);
+  this->m_length += size;
+  this->m_last = point;
+  ++this->m_num;
+}
+
+void SeriesBuffer::m_evict(uint16_t size) {
+  // Free some more space to evict rarely
+  size += CAPACITY / 8;
+  const uint8_t *const end = this->m_data + this->m_length;
+  const uint8_t *it = this->m_data;
+  while (it - this->m_data < size && it < end) {
+    if ((it = decode(it, end, this->m_base)) == nullptr) {
+      this->clear();
+      return;
+    }
+    --this->m_num;
+  }
+  this->m_length = end - it;
+  std::memmove(this->m_data, it, this->m_length);
+}
+
+size_t SeriesBuffer::write(Print &out, uint8_t tier, uint16_t interval) const {
+  uint8_t header[HEADER_SIZE];
+  uint8_t *it = std::copy(SERIALIZED_MAGIC, SERIALIZED_MAGIC + sizeof(SERIALIZED_MAGIC), header);
+  *it++ = SERIALIZED_VERSION;
+  *it++ = tier;
+  *it++ = interval;
+  *it++ = interval >> 8;
+  *it++ = this->m_num;
+  *it++ = this->m_num >> 8;
+  it = putU32(it, this->m_base.time);
+  for (int16_t temp : {this->m_base.indoorTemp, this->m_base.outdoorTemp, this->m_base.targetTemp}) {
+    *it++ = temp;
+    *it++ = temp >> 8;
+  }
+  *it++ = this->m_base.mode;
+  *it++ = this->m_length;
+  *it++ = this->m_length >> 8;
+  return out.write(header, sizeof(header)) + out.write(this->m_data, this->m_length);
+}
+
+// Rounded average
+static int16_t average(int32_t sum, int32_t num) { return (sum + (sum < 0 ? -num / 2 : num / 2)) / num; }
+
+void TimeSeries::add(uint32_t time, const AcState &state) {
+  const SeriesPoint point{time, state.indoorTemp, state.outdoorTemp, state.targetTemp, state.mode};
+  // Changes tier
+  SeriesBuffer &changes = this->m_tiers[0];
+  const SeriesPoint &last = changes.last();
+  if (!changes.size() || point.mode != last.mode ||
+      (time - last.time >= INTERVALS[0] && (point.indoorTemp != last.indoorTemp ||
+                                            point.outdoorTemp != last.outdoorTemp ||
+                                            point.targetTemp != last.targetTemp)))
+    changes.add(point);
+  // Averaging tiers
+  for (uint8_t tier = 1; tier < NUM_TIERS; ++tier) {
+    Window &window = this->m_windows[tier];
+    const uint32_t start = time - time % INTERVALS[tier];
+    if (window.num && start != window.start) {
+      this->m_tiers[tier].add({window.start, average(window.indoorTemp, window.num),
+                               average(window.outdoorTemp, window.num), average(window.targetTemp, window.num),
+                               window.mode});
+      window = {};
+    }
+    window.start = start;
+    window.indoorTemp += point.indoorTemp;
+    window.outdoorTemp += point.outdoorTemp;
+    window.targetTemp += point.targetTemp;
+    window.mode = point.mode;
+    ++window.num;
+  }
+}
+
+uint16_t TimeSeries::getInterval(uint8_t tier) { return (tier < NUM_TIERS) ? INTERVALS[tier] : 0; }
+
+size_t TimeSeries::exportSize() const {
+  size_t size = 0;
+  for (auto &tier : this->m_tiers)
+    size += tier.blockSize();
+  return size;
+}
+
+size_t TimeSeries::write(Print &out) const {
+  size_t size = 0;
+  for (uint8_t tier = 0; tier < NUM_TIERS; ++tier)
+    size += this->m_tiers[tier].write(out, tier, INTERVALS[tier]);
+  return size;
+}
+
+}  // namespace ac
+}  // namespace midea
+}  // namespace dudanov
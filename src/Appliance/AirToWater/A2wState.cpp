@@ -0,0 +1,36 @@
+#include "Appliance/AirToWater/A2wState.h"
+
+namespace dudanov {
+namespace midea {
+namespace a2w {
+
+uint16_t A2wState::diff(const A2wState &other) const {
+  uint16_t mask = 0;
+  if (this->zones[0] != other.zones[0])
+    mask |= CHANGE_ZONE1;
+  if (this->zones[1] != other.zones[1])
+    mask |= CHANGE_ZONE2;
+  if (this->mode != other.mode)
+    mask |= CHANGE_MODE;
+  if (this->dhwPower != other.dhwPower || this->dhwTargetTemp != other.dhwTargetTemp)
+    mask |= CHANGE_DHW;
+  if (this->dhwTemp != other.dhwTemp)
+    mask |= CHANGE_DHW_TEMP;
+  if (this->roomTargetTemp != other.roomTargetTemp)
+    mask |= CHANGE_ROOM_TARGET_TEMP;
+  if (this->outdoorTemp != other.outdoorTemp)
+    mask |= CHANGE_OUTDOOR_TEMP;
+  if (this->waterInTemp != other.waterInTemp || this->waterOutTemp != other.waterOutTemp)
+    mask |= CHANGE_WATER_TEMP;
+  if (this->compressorFrequency != other.compressorFrequency)
+    mask |= CHANGE_COMPRESSOR;
+  if (this->energyConsumed != other.energyConsumed || this->energyProduced != other.energyProduced)
+    mask |= CHANGE_ENERGY;
+  if (this->errorCode != other.errorCode)
+    mask |= CHANGE_ERROR;
+  return mask;
+}
+
+}  // namespace a2w
+}  // namespace midea
+}  // namespace dudanov
@@ -0,0 +1,85 @@
+#include "Appliance/AirToWater/AirToWater.h"
+#include "Helpers/Timer.h"
+#include "Helpers/Log.h"
+
+namespace dudanov {
+namespace midea {
+namespace a2w {
+
+static const char *TAG = "AirToWater";
+static const ZoneState NO_ZONE{};
+
+const ZoneState &AirToWater::getZone(uint8_t zone) const {
+  return (zone < this->m_numZones) ? this->m_state.zones[zone] : NO_ZONE;
+}
+
+void AirToWater::control(const Control &control) {
+  if (this->m_sendControl)
+    return;
+  const A2wState &state = this->m_state;
+  ControlData data{};
+  bool hasUpdate = false;
+  for (uint8_t zone = 0; zone < this->m_numZones; ++zone) {
+    bool power = state.zones[zone].power;
+    uint8_t targetTemp = state.zones[zone].targetTemp;
+    if (control.zonePower[zone].hasUpdate(power)) {
+      hasUpdate = true;
+      power = control.zonePower[zone].value();
+    }
+    if (control.zoneTargetTemp[zone].hasUpdate(targetTemp)) {
+      hasUpdate = true;
+      targetTemp = control.zoneTargetTemp[zone].value();
+    }
+    data.setZonePower(zone, power);
+    data.setZoneTargetTemp(zone, targetTemp);
+    data.setZoneCurve(zone, state.zones[zone].curve);
+  }
+  Mode mode = state.mode;
+  if (control.mode.hasUpdate(mode)) {
+    hasUpdate = true;
+    mode = control.mode.value();
+  }
+  bool dhwPower = state.dhwPower;
+  if (control.dhwPower.hasUpdate(dhwPower)) {
+    hasUpdate = true;
+    dhwPower = control.dhwPower.value();
+  }
+  uint8_t dhwTargetTemp = state.dhwTargetTemp;
+  if (control.dhwTargetTemp.hasUpdate(dhwTargetTemp)) {
+    hasUpdate = true;
+    dhwTargetTemp = control.dhwTargetTemp.value();
+  }
+  if (!hasUpdate)
+    return;
+  data.setMode(mode);
+  data.setDhwPower(dhwPower);
+  data.setDhwTargetTemp(dhwTargetTemp);
+  data.setRoomTargetTemp(state.roomTargetTemp);
+  data.appendCRC();
+  this->m_sendControl = true;
+  LOG_D(TAG, "Enqueuing a priority SET_STATUS(0x01) request...");
+  this->m_queueRequest(FrameType::DEVICE_CONTROL, std::move(data),
+    // onData
+    ResponseHandler::bind<&AirToWater::m_readResponse>(this),
+    // onSuccess
+    [this]() {
+      this->m_sendControl = false;
+    },
+    // onError
+    [this]() {
+      LOG_W(TAG, "SET_STATUS(0x01) request failed...");
+      this->m_sendControl = false;
+    },
+    PRIORITY_CONTROL
+  );
+}
+
+void AirToWater::m_onDecoded(uint8_t /*idx*/, const uint8_t * /*data*/, uint8_t /*size*/, A2wState &state) {
+  // Zone 2 fields are meaningless in single zone installations
+  if (this->m_numZones < 2)
+    state.zones[1] = this->m_state.zones[1];
+}
+
+}  // namespace a2w
+}  // namespace midea
+}  // namespace dudanov
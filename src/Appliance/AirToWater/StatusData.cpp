@@ -0,0 +1,69 @@
+#include "Appliance/AirToWater/StatusData.h"
+#include "Appliance/AirToWater/A2wState.h"
+
+namespace dudanov {
+namespace midea {
+namespace a2w {
+
+static uint32_t getU32BE(const uint8_t *data) {
+  return (static_cast<uint32_t>(data[0]) << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+}
+
+static void decodeBasic(const uint8_t *data, A2wState &state) {
+  using Layout = BasicLayout;
+  state.zones[0].power = Layout::Zone1Power::get(data);
+  state.zones[0].curve = Layout::Zone1Curve::get(data);
+  state.zones[0].targetTemp = Layout::Zone1TargetTemp::get(data);
+  state.zones[1].power = Layout::Zone2Power::get(data);
+  state.zones[1].curve = Layout::Zone2Curve::get(data);
+  state.zones[1].targetTemp = Layout::Zone2TargetTemp::get(data);
+  const uint8_t mode = Layout::Mode::get(data);
+  if (mode >= MODE_AUTO && mode <= MODE_HEAT)
+    state.mode = static_cast<Mode>(mode);
+  state.dhwPower = Layout::DhwPower::get(data);
+  state.dhwTargetTemp = Layout::DhwTargetTemp::get(data);
+  state.dhwTemp = Layout::DhwTemp::get(data);
+  state.roomTargetTemp = Layout::RoomTargetTemp::get(data);
+  state.errorCode = Layout::ErrorCode::get(data);
+}
+
+static void decodeEnergy(const uint8_t *data, A2wState &state) {
+  using Layout = EnergyLayout;
+  state.energyConsumed = getU32BE(data + Layout::CONSUMED);
+  state.energyProduced = getU32BE(data + Layout::PRODUCED);
+  state.outdoorTemp = static_cast<int8_t>(Layout::OutdoorTemp::get(data));
+}
+
+static void decodeUnit(const uint8_t *data, A2wState &state) {
+  using Layout = UnitLayout;
+  state.compressorFrequency = Layout::CompressorFrequency::get(data);
+  state.waterInTemp = static_cast<int8_t>(Layout::WaterInTemp::get(data));
+  state.waterOutTemp = static_cast<int8_t>(Layout::WaterOutTemp::get(data));
+}
+
+bool StatusView::decode(A2wState &state) const {
+  // Bodies are long enough for unchecked access, otherwise they are rejected
+  switch (this->getBodyType()) {
+    case BODY_BASIC:
+      if (this->m_size < BasicLayout::SIZE)
+        return false;
+      decodeBasic(this->m_data, state);
+      return true;
+    case BODY_ENERGY:
+      if (this->m_size < EnergyLayout::SIZE)
+        return false;
+      decodeEnergy(this->m_data, state);
+      return true;
+    case BODY_UNIT:
+      if (this->m_size < UnitLayout::SIZE)
+        return false;
+      decodeUnit(this->m_data, state);
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace a2w
+}  // namespace midea
+}  // namespace dudanov
@@ -1,15 +1,17 @@
 #include "Appliance/ApplianceBase.h"
 #include "Helpers/Log.h"
-#ifdef ARDUINO_ARCH_ESP32
-#include <WiFi.h>
-#else
-#include <ESP8266WiFi.h>
-#endif
+#include <algorithm>
 
 namespace dudanov {
 namespace midea {
 
 static const char *TAG = "ApplianceBase";
+#if defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_ESP8266)
+static WiFiProvider s_defaultProvider;
+#else
+// No WiFi on this target: appliance sees connected network
+static StaticNetworkProvider s_defaultProvider;
+#endif
 
 ResponseStatus ApplianceBase::Request::callHandler(const Frame &frame) {
   if (!frame.hasType(this->requestType))
@@ -19,9 +21,9 @@ ResponseStatus ApplianceBase::Request::callHandler(const Frame &frame) {
   return this->onData(frame.getData());
 }
 
-bool ApplianceBase::FrameReceiver::read(Stream *stream) {
-  while (stream->available()) {
-    const uint8_t data = stream->read();
+bool ApplianceBase::FrameReceiver::read(Transport *transport) {
+  uint8_t data;
+  while (transport->read(&data, 1)) {
     const uint8_t length = this->m_data.size();
     if (length == OFFSET_START && data != START_BYTE)
       continue;
@@ -40,60 +42,162 @@ bool ApplianceBase::FrameReceiver::read(Stream *stream) {
 }
 
 void ApplianceBase::setup() {
+  this->m_setupTime = TimerManager::update();
   this->m_timerManager.registerTimer(this->m_periodTimer);
   this->m_timerManager.registerTimer(this->m_networkTimer);
-  this->m_timerManager.registerTimer(this->m_responseTimer);
+  for (auto &slot : this->m_slots)
+    this->m_timerManager.registerTimer(slot.timer);
   this->m_networkTimer.setCallback([this](Timer *timer) {
+    // Signal strength changes without events
+    this->updateNetwork();
     this->m_sendNetworkNotify();
     timer->reset();
   });
   this->m_networkTimer.start(2 * 60 * 1000);
-  this->m_networkTimer.call();
+  // Appliance enqueues its startup requests first, network notify is less urgent
   this->m_setup();
+  this->m_networkTimer.call();
+}
+
+void ApplianceBase::m_setReady() {
+  if (this->m_isReady)
+    return;
+  this->m_isReady = true;
+  this->m_timeToReady = TimerManager::ms() - this->m_setupTime;
+  LOG_I(TAG, "First appliance state received in %u ms.", static_cast<unsigned>(this->m_timeToReady));
+  this->m_readyCallbacks.call(this->m_timeToReady);
 }
 
 void ApplianceBase::loop() {
+  this->m_process();
+  // Frames written by this loop are sent together
+  this->m_transport->flush();
+}
+
+void ApplianceBase::m_process() {
   // Timers task
   m_timerManager.task();
   // Loop for appliances
   m_loop();
+  if (this->m_networkProvider->getRevision() != this->m_networkRevision)
+    this->updateNetwork();
   // Frame receiving
-  while (this->m_receiver.read(this->m_stream)) {
+  while (this->m_receiver.read(this->m_transport)) {
     this->m_protocol = this->m_receiver.getProtocol();
     LOG_D(TAG, "RX: %s", this->m_receiver.toString().c_str());
     this->m_handler(this->m_receiver);
     this->m_receiver.clear();
   }
-  if (this->m_isBusy || this->m_isWaitForResponse())
+  if (this->m_linkState == LINK_OFFLINE) {
+    this->m_failControls();
+    if (TimerManager::ms() - this->m_probeTime < this->m_probeInterval)
+      return;
+  }
+  if (this->m_isBusy)
     return;
-  if (this->m_queue.empty()) {
-    this->m_onIdle();
+  // Offline appliance is probed with single request
+  if (this->m_numInFlight >= (this->m_linkState == LINK_OFFLINE ? 1 : this->m_window))
+    return;
+  // Request of group waits for completion of previous one
+  if (this->m_numInFlight && !this->m_queue.empty() && this->m_queue.front()->chained)
+    return;
+  Request *request = this->m_popRequest();
+  if (request == nullptr) {
+    // Adaptive period shortens only gaps between queued requests, idle polling keeps fixed period
+    if (!this->m_numInFlight && TimerManager::ms() - this->m_frameTime >= this->m_period)
+      this->m_onIdle();
     return;
   }
-  this->m_request = this->m_queue.front();
-  this->m_queue.pop_front();
   LOG_D(TAG, "Getting and sending a request from the queue...");
-  this->m_sendRequest(this->m_request);
-  if (this->m_request->onData != nullptr) {
-    this->m_resetAttempts();
-    this->m_resetTimeout();
-  } else {
-    this->m_destroyRequest();
+  if (!this->m_sendRequest(request)) {
+    // Response will never come: fail at once instead of waiting for timeout
+    LOG_W(TAG, "Transport has dropped the request.");
+    this->m_failRequest(request);
+    return;
   }
+  if (request->onData == nullptr) {
+    this->m_deleteRequest(request);
+    return;
+  }
+  this->m_startRequest(request);
+}
+
+uint32_t ApplianceBase::getWakeDelay() const {
+  // Response timeouts, end of request period and network notifies
+  const uint32_t delay = this->m_timerManager.getDelay();
+  const TimerTick ms = TimerManager::ms();
+  if (this->m_linkState == LINK_OFFLINE) {
+    const uint32_t elapsed = ms - this->m_probeTime;
+    if (elapsed < this->m_probeInterval)
+      return std::min(delay, this->m_probeInterval - elapsed);
+  }
+  if (this->m_isBusy)
+    return delay;
+  if (this->m_numInFlight >= (this->m_linkState == LINK_OFFLINE ? 1 : this->m_window))
+    return delay;
+  if (!this->m_queue.empty())
+    return (this->m_numInFlight && this->m_queue.front()->chained) ? delay : 0;
+  if (this->m_numInFlight)
+    return delay;
+  const uint32_t elapsed = ms - this->m_frameTime;
+  if (elapsed < this->m_period)
+    return std::min(delay, this->m_period - elapsed);
+  return std::min(delay, this->m_getIdleDelay());
+}
+
+void ApplianceBase::m_startRequest(Request *request) {
+  for (auto &slot : this->m_slots) {
+    if (slot.request != nullptr)
+      continue;
+    slot.request = request;
+    slot.requestTime = TimerManager::ms();
+    slot.sequence = this->m_sequence++;
+    slot.numMismatches = 0;
+    slot.hasMessageID = request->request.hasMessageID();
+    this->m_resetAttempts(slot);
+    this->m_resetTimeout(slot);
+    ++this->m_numInFlight;
+    return;
+  }
+}
+
+uint8_t ApplianceBase::m_sortSlots(Slot **slots) {
+  uint8_t num = 0;
+  for (auto &slot : this->m_slots) {
+    if (slot.request == nullptr)
+      continue;
+    // Insertion sort by sequence number
+    uint8_t n = num++;
+    for (; n > 0 && static_cast<int32_t>(slots[n - 1]->sequence - slot.sequence) > 0; --n)
+      slots[n] = slots[n - 1];
+    slots[n] = &slot;
+  }
+  return num;
 }
 
 void ApplianceBase::m_handler(const Frame &frame) {
-  if (this->m_isWaitForResponse()) {
-    auto result = this->m_request->callHandler(frame);
-    if (result != RESPONSE_WRONG) {
-      if (result == RESPONSE_OK) {
-        if (this->m_request->onSuccess != nullptr)
-          this->m_request->onSuccess();
-        this->m_destroyRequest();
-      } else {
-        this->m_resetAttempts();
-        this->m_resetTimeout();
-      }
+  // Any valid frame means appliance is alive
+  this->m_numFailures = 0;
+  this->m_setLinkState(LINK_ONLINE);
+  const FrameData data = frame.getData();
+  // Response goes to the oldest request accepting it
+  Slot *slots[MAX_WINDOW];
+  const uint8_t num = this->m_sortSlots(slots);
+  for (uint8_t n = 0; n < num; ++n)
+    if (this->m_isMatched(*slots[n], data) && this->m_handleResponse(*slots[n], frame, data))
+      return;
+  if (this->m_isStale(frame, data)) {
+    ++this->m_numStale;
+    LOG_D(TAG, "Discarding late response to retired request.");
+    return;
+  }
+  for (uint8_t n = 0; n < num; ++n)
+    if (!this->m_isMatched(*slots[n], data) && slots[n]->numMismatches < UINT8_MAX)
+      ++slots[n]->numMismatches;
+  /* UNSOLICITED FRAMES */
+  for (uint8_t n = 0; n < this->m_numRoutes; ++n) {
+    if (frame.hasType(this->m_routes[n].type)) {
+      this->m_routes[n].handler(frame);
       return;
     }
   }
@@ -108,75 +212,330 @@ void ApplianceBase::m_handler(const Frame &frame) {
   this->m_onRequest(frame);
 }
 
-static uint8_t getSignalStrength() {
-  const int32_t dbm = WiFi.RSSI();
-  if (dbm > -63)
-    return 4;
-  if (dbm > -75)
-    return 3;
-  if (dbm > -88)
-    return 2;
-  return 1;
+bool ApplianceBase::m_handleResponse(Slot &slot, const Frame &frame, const FrameData &data) {
+  const uint32_t rtt = TimerManager::ms() - slot.requestTime;
+  Request *request = slot.request;
+  const auto result = request->callHandler(frame);
+  if (result == RESPONSE_WRONG)
+    return false;
+  // Karn's rule: response to retransmitted frame is ambiguous
+  if (!slot.numRetries)
+    this->m_rtt.addSample(rtt);
+  Echo *echo = slot.hasMessageID ? this->m_findEcho(data.data()[0], true) : nullptr;
+  if (echo != nullptr && echo->numEchoes < NUM_ECHOES_TO_MATCH) {
+    // Learn if appliance echoes message ID in responses of this type
+    if (data.getMessageID() != request->request.getMessageID()) {
+      echo->numEchoes = 0;
+    } else if (++echo->numEchoes == NUM_ECHOES_TO_MATCH) {
+      LOG_I(TAG, "Appliance echoes message IDs in 0x%02X responses. They are matched strictly.", echo->type);
+    }
+  }
+  if (result == RESPONSE_OK) {
+    if (request->onSuccess != nullptr)
+      request->onSuccess();
+    this->m_retireRequest(request);
+    this->m_destroyRequest(slot);
+  } else {
+    // Handler has sent next frame with unknown message ID
+    slot.hasMessageID = false;
+    slot.requestTime = TimerManager::ms();
+    this->m_resetAttempts(slot);
+    this->m_resetTimeout(slot);
+  }
+  return true;
 }
 
-void ApplianceBase::m_sendNetworkNotify(FrameType msgType) {
+bool ApplianceBase::m_addRoute(FrameType type, FrameHandler handler) {
+  if (this->m_numRoutes >= MAX_ROUTES || handler == nullptr)
+    return false;
+  this->m_routes[this->m_numRoutes++] = {type, handler};
+  return true;
+}
+
+void ApplianceBase::setNetworkProvider(NetworkProvider *provider) {
+  this->m_networkProvider = (provider != nullptr) ? provider : &s_defaultProvider;
+  // Revisions of different providers are not comparable
+  if (this->m_networkTimer.isEnabled())
+    this->updateNetwork();
+}
+
+void ApplianceBase::updateNetwork() {
+  if (this->m_networkProvider == nullptr)
+    this->m_networkProvider = &s_defaultProvider;
+  this->m_networkRevision = this->m_networkProvider->getRevision();
+  const NetworkStatus status = this->m_networkProvider->getStatus();
   NetworkNotifyData notify{};
-  notify.setConnected(WiFi.isConnected());
-  notify.setSignalStrength(getSignalStrength());
-  notify.setIP(WiFi.localIP());
+  notify.setConnected(status.connected);
+  notify.setSignalStrength(status.signalStrength);
+  notify.setIP(status.ip);
   notify.appendCRC();
+  this->m_networkReply = Frame(this->m_appType, this->m_protocol, QUERY_NETWORK, notify);
+  this->m_networkNotify = std::move(notify);
+}
+
+void ApplianceBase::m_sendNetworkNotify(FrameType msgType) {
   if (msgType == NETWORK_NOTIFY) {
     LOG_D(TAG, "Enqueuing a DEVICE_NETWORK(0x0D) notification...");
-    this->m_queueNotify(msgType, std::move(notify));
-  } else {
-    LOG_D(TAG, "Answer to QUERY_NETWORK(0x63) request...");
-    this->m_sendFrame(msgType, std::move(notify));
+    this->m_queueNotify(msgType, this->m_networkNotify);
+    return;
   }
+  LOG_D(TAG, "Answer to QUERY_NETWORK(0x63) request...");
+  // Protocol version may be learned after caching
+  if (this->m_networkReply.getProtocol() != this->m_protocol)
+    this->m_networkReply = Frame(this->m_appType, this->m_protocol, QUERY_NETWORK, this->m_networkNotify);
+  this->m_writeFrame(this->m_networkReply);
 }
 
-void ApplianceBase::m_resetTimeout() {
-  this->m_responseTimer.setCallback([this](Timer *timer) {
-    LOG_D(TAG, "Response timeout...");
-    if (!--this->m_remainAttempts) {
-      if (this->m_request->onError != nullptr)
-        this->m_request->onError();
-      this->m_destroyRequest();
-      return;
+void ApplianceBase::m_resetTimeout(Slot &slot) {
+  slot.timer.setCallback([this, &slot](Timer *timer) { this->m_onTimeout(slot); });
+  slot.timer.start(this->m_getTimeout(slot.numRetries));
+}
+
+void ApplianceBase::m_onTimeout(Slot &slot) {
+  LOG_D(TAG, "Response timeout...");
+  ++this->m_numTimeouts;
+  if (!--slot.remainAttempts) {
+    Request *request = slot.request;
+    slot.request = nullptr;
+    slot.timer.stop();
+    --this->m_numInFlight;
+    this->m_onLinkFailure();
+    if (slot.numMismatches) {
+      // Appliance may have stopped echoing IDs. Learn again.
+      LOG_W(TAG, "Responses with foreign message IDs received. Strict matching disabled.");
+      this->m_numEchoTypes = 0;
     }
-    LOG_D(TAG, "Sending request again. Attempts left: %d...", this->m_remainAttempts);
-    this->m_sendRequest(this->m_request);
-    this->m_resetTimeout();
-  });
-  this->m_responseTimer.start(this->m_timeout);
+    this->m_retireRequest(request);
+    this->m_failRequest(request);
+    return;
+  }
+  LOG_D(TAG, "Sending request again. Attempts left: %d...", slot.remainAttempts);
+  this->m_sendRequest(slot.request);
+  slot.requestTime = TimerManager::ms();
+  ++slot.numRetries;
+  this->m_resetTimeout(slot);
+}
+
+uint32_t ApplianceBase::m_getTimeout(uint8_t numRetries) const {
+  if (!this->m_isAdaptive || !this->m_rtt.hasSamples())
+    return this->m_timeout;
+  // Timeout is doubled on each retry
+  uint32_t timeout = this->m_rtt.getTimeout(this->m_minTimeout, this->m_maxTimeout);
+  for (; numRetries && timeout < this->m_maxTimeout; --numRetries)
+    timeout *= 2;
+  return std::min(timeout, this->m_maxTimeout);
+}
+
+uint32_t ApplianceBase::m_getPeriod() const {
+  if (!this->m_isAdaptive || !this->m_rtt.hasSamples())
+    return this->m_period;
+  // Appliance is ready for next request after twice of smoothed round-trip time
+  return std::max(this->m_minPeriod, std::min(2 * this->m_rtt.getSmoothed(), this->m_period));
+}
+
+ApplianceBase::Echo *ApplianceBase::m_findEcho(uint8_t type, bool create) {
+  for (uint8_t n = 0; n < this->m_numEchoTypes; ++n)
+    if (this->m_echoes[n].type == type)
+      return &this->m_echoes[n];
+  if (!create || this->m_numEchoTypes >= NUM_ECHO_TYPES)
+    return nullptr;
+  Echo *echo = &this->m_echoes[this->m_numEchoTypes++];
+  *echo = {type, 0};
+  return echo;
+}
+
+bool ApplianceBase::m_isMatched(const Slot &slot, const FrameData &data) const {
+  return !slot.hasMessageID || !this->m_isStrict(data) || data.getMessageID() == slot.request->request.getMessageID();
+}
+
+bool ApplianceBase::m_isStale(const Frame &frame, const FrameData &data) const {
+  if (!(frame.hasType(DEVICE_CONTROL) || frame.hasType(DEVICE_QUERY)) || !this->m_isStrict(data))
+    return false;
+  const uint8_t id = data.getMessageID();
+  for (uint8_t n = 0; n < this->m_numRetired; ++n)
+    if (this->m_retiredIDs[n] == id)
+      return true;
+  return false;
+}
+
+void ApplianceBase::m_retireRequest(const Request *request) {
+  if (!request->request.hasMessageID())
+    return;
+  this->m_retiredIDs[this->m_retiredPos] = request->request.getMessageID();
+  this->m_retiredPos = (this->m_retiredPos + 1) % NUM_RETIRED_IDS;
+  if (this->m_numRetired < NUM_RETIRED_IDS)
+    ++this->m_numRetired;
+}
+
+void ApplianceBase::m_setLinkState(LinkState state) {
+  if (state == this->m_linkState)
+    return;
+  static const char *const NAMES[] = {"ONLINE", "DEGRADED", "OFFLINE"};
+  LOG_I(TAG, "Link state: %s -> %s.", NAMES[this->m_linkState], NAMES[state]);
+  this->m_linkState = state;
+  this->m_linkCallbacks.call(state);
 }
 
-void ApplianceBase::m_destroyRequest() {
+void ApplianceBase::m_onLinkFailure() {
+  if (this->m_numFailures < UINT8_MAX)
+    ++this->m_numFailures;
+  this->m_probeTime = TimerManager::ms();
+  if (this->m_linkState == LINK_OFFLINE) {
+    this->m_probeInterval = std::min(2 * this->m_probeInterval, this->m_maxProbeInterval);
+    LOG_D(TAG, "Appliance is offline. Next probe in %u ms.", static_cast<unsigned>(this->m_probeInterval));
+  } else if (this->m_numFailures >= this->m_offlineThreshold) {
+    this->m_probeInterval = this->m_minProbeInterval;
+    this->m_setLinkState(LINK_OFFLINE);
+  } else {
+    this->m_setLinkState(LINK_DEGRADED);
+  }
+}
+
+void ApplianceBase::m_failControls() {
+  auto isControl = [](const Request *request) { return request->priority == PRIORITY_CONTROL; };
+  // Search again after each `onError` call: it may enqueue new requests
+  for (auto it = std::find_if(this->m_queue.begin(), this->m_queue.end(), isControl); it != this->m_queue.end();
+       it = std::find_if(this->m_queue.begin(), this->m_queue.end(), isControl)) {
+    Request *request = *it;
+    this->m_queue.erase(it);
+    LOG_W(TAG, "Appliance is offline. Control request failed.");
+    if (request->onError != nullptr)
+      request->onError();
+    this->m_deleteRequest(request);
+  }
+}
+
+LinkStats ApplianceBase::getLinkStats() const {
+  LinkStats stats{};
+  stats.srtt = this->m_rtt.getSmoothed();
+  stats.rttvar = this->m_rtt.getDeviation();
+  stats.minRtt = this->m_rtt.hasSamples() ? this->m_rtt.getMin() : 0;
+  stats.maxRtt = this->m_rtt.getMax();
+  stats.timeout = this->m_getTimeout();
+  stats.period = this->m_getPeriod();
+  stats.numSamples = this->m_rtt.getNumSamples();
+  stats.numTimeouts = this->m_numTimeouts;
+  stats.numStale = this->m_numStale;
+  return stats;
+}
+
+MemoryUsage ApplianceBase::getMemoryUsage() const {
+  MemoryUsage usage{};
+  usage.requests = this->m_queueMemory + (this->m_queue.size() + this->m_group.capacity()) * sizeof(Request *);
+  usage.buffers = this->m_receiver.capacity() + this->m_networkReply.capacity() + this->m_networkNotify.capacity();
+  usage.callbacks = this->m_stateCallbacks.capacity() * sizeof(OnStateCallback);
+  return usage;
+}
+
+void ApplianceBase::m_destroyRequest(Slot &slot) {
   LOG_D(TAG, "Destroying the request...");
-  this->m_responseTimer.stop();
-  delete this->m_request;
-  this->m_request = nullptr;
+  slot.timer.stop();
+  this->m_deleteRequest(slot.request);
+  slot.request = nullptr;
+  --this->m_numInFlight;
+}
+
+bool ApplianceBase::m_sendFrame(FrameType type, const FrameData &data) {
+  return this->m_writeFrame(Frame(this->m_appType, this->m_protocol, type, data));
 }
 
-void ApplianceBase::m_sendFrame(FrameType type, const FrameData &data) {
-  Frame frame(this->m_appType, this->m_protocol, type, data);
+bool ApplianceBase::m_writeFrame(const Frame &frame) {
   LOG_D(TAG, "TX: %s", frame.toString().c_str());
-  this->m_stream->write(frame.data(), frame.size());
+  const bool isWritten = this->m_transport->write(frame.data(), frame.size()) == frame.size();
+  this->m_frameTime = TimerManager::ms();
   this->m_isBusy = true;
   this->m_periodTimer.setCallback([this](Timer *timer) {
     this->m_isBusy = false;
     timer->stop();
   });
-  this->m_periodTimer.start(this->m_period);
+  this->m_periodTimer.start(this->m_getPeriod());
+  return isWritten;
 }
 
-void ApplianceBase::m_queueRequest(FrameType type, FrameData data, ResponseHandler onData, Handler onSuccess, Handler onError) {
-  LOG_D(TAG, "Enqueuing the request...");
-  this->m_queue.push_back(new Request{std::move(data), std::move(onData), std::move(onSuccess), std::move(onError), type});
+void ApplianceBase::m_queueRequest(FrameType type, FrameData data, ResponseHandler onData, Handler onSuccess,
+                                   Handler onError, RequestPriority priority, uint32_t timeToLive) {
+  LOG_D(TAG, "Enqueuing the request with priority %d...", priority);
+  const size_t size = sizeof(Request) + data.size();
+  // Groups are short control sequences and are never split
+  if (this->m_memoryBudget && !this->m_isGroup && !this->m_reserve(size, priority)) {
+    LOG_W(TAG, "Request queue is over memory budget. Request dropped.");
+    if (onError != nullptr)
+      onError();
+    return;
+  }
+  auto request =
+      new Request{std::move(data), onData, onSuccess, onError, type, priority, false, 0, timeToLive, TimerManager::ms()};
+  this->m_queueMemory += size;
+  if (!this->m_isGroup) {
+    this->m_pushRequest(request);
+    return;
+  }
+  if (!this->m_group.empty()) {
+    request->priority = this->m_group.front()->priority;
+    request->chained = true;
+  } else if (!++this->m_groupId) {
+    this->m_groupId = 1;
+  }
+  request->group = this->m_groupId;
+  this->m_group.push_back(request);
 }
 
-void ApplianceBase::m_queueRequestPriority(FrameType type, FrameData data, ResponseHandler onData, Handler onSuccess, Handler onError) {
-  LOG_D(TAG, "Priority request queuing...");
-  this->m_queue.push_front(new Request{std::move(data), std::move(onData), std::move(onSuccess), std::move(onError), type});
+bool ApplianceBase::m_reserve(size_t size, RequestPriority priority) {
+  while (this->m_queueMemory + size > this->m_memoryBudget) {
+    if (this->m_queue.empty())
+      return false;
+    Request *request = this->m_queue.back();
+    if (request->priority <= priority || request->chained)
+      return false;
+    LOG_D(TAG, "Evicting queued request of lower priority...");
+    this->m_queue.pop_back();
+    if (request->onError != nullptr)
+      request->onError();
+    this->m_deleteRequest(request);
+  }
+  return true;
+}
+
+void ApplianceBase::m_endGroup() {
+  this->m_isGroup = false;
+  if (this->m_group.empty())
+    return;
+  this->m_queue.insert(this->m_findPosition(this->m_group.front()->priority), this->m_group.begin(), this->m_group.end());
+  this->m_group.clear();
+}
+
+std::deque<ApplianceBase::Request *>::iterator ApplianceBase::m_findPosition(RequestPriority priority) {
+  // Before first request of lower priority, but never inside a group
+  return std::find_if(this->m_queue.begin(), this->m_queue.end(), [priority](const Request *request) {
+    return request->priority > priority && !request->chained;
+  });
+}
+
+ApplianceBase::Request *ApplianceBase::m_popRequest() {
+  while (!this->m_queue.empty()) {
+    Request *request = this->m_queue.front();
+    this->m_queue.pop_front();
+    if (!request->isExpired())
+      return request;
+    LOG_D(TAG, "Dropping the stale request...");
+    this->m_failRequest(request);
+  }
+  return nullptr;
+}
+
+void ApplianceBase::m_failRequest(Request *request) {
+  // With window, failed request may be unrelated to group waiting at queue front
+  const uint16_t group = request->group;
+  do {
+    if (request->onError != nullptr)
+      request->onError();
+    this->m_deleteRequest(request);
+    if (!group || this->m_queue.empty() || !this->m_queue.front()->chained || this->m_queue.front()->group != group)
+      return;
+    LOG_D(TAG, "Dropping the rest of request group...");
+    request = this->m_queue.front();
+    this->m_queue.pop_front();
+  } while (true);
 }
 
 void ApplianceBase::setBeeper(bool value) {
@@ -0,0 +1,98 @@
+#include "Appliance/Dehumidifier/Dehumidifier.h"
+#include "Helpers/Timer.h"
+#include "Helpers/Log.h"
+
+namespace dudanov {
+namespace midea {
+namespace dh {
+
+static const char *TAG = "Dehumidifier";
+
+bool DhDescriptor::decodeStatus(const uint8_t *data, uint8_t size, DhState &state) {
+  // Writable part of status is copied to control frames
+  if (size < 10)
+    return false;
+  StatusData::decodeAll(data, size, state);
+  return true;
+}
+
+void Dehumidifier::control(const Control &control) {
+  if (this->m_sendControl)
+    return;
+  StatusData status = this->m_status;
+  bool hasUpdate = false;
+  if (control.power.hasUpdate(this->m_state.power)) {
+    hasUpdate = true;
+    status.setPower(control.power.value());
+  }
+  if (control.mode.hasUpdate(this->m_state.mode)) {
+    hasUpdate = true;
+    // Mode change turns appliance on, like on remote
+    status.setPower(true);
+    status.setMode(control.mode.value());
+  }
+  if (control.fanSpeed.hasUpdate(this->m_state.fanSpeed)) {
+    hasUpdate = true;
+    status.setFanSpeed(control.fanSpeed.value());
+  }
+  if (control.targetHumidity.hasValue()) {
+    uint8_t value = control.targetHumidity.value();
+    if (value < MIN_TARGET_HUMIDITY)
+      value = MIN_TARGET_HUMIDITY;
+    else if (value > MAX_TARGET_HUMIDITY)
+      value = MAX_TARGET_HUMIDITY;
+    if (value != this->m_state.targetHumidity) {
+      hasUpdate = true;
+      status.setTargetHumidity(value);
+    }
+  }
+  if (control.ion.hasUpdate(this->m_state.ion)) {
+    hasUpdate = true;
+    status.setIon(control.ion.value());
+  }
+  if (hasUpdate) {
+    this->m_sendControl = true;
+    status.setBeeper(this->m_beeper);
+    status.appendCRC();
+    this->m_setStatus(std::move(status));
+  }
+}
+
+MemoryUsage Dehumidifier::getMemoryUsage() const {
+  MemoryUsage usage = Appliance::getMemoryUsage();
+  usage.buffers += this->m_status.capacity();
+  return usage;
+}
+
+void Dehumidifier::m_setStatus(StatusData status) {
+  LOG_D(TAG, "Enqueuing a priority SET_STATUS(0x48) request...");
+  this->m_queueRequest(FrameType::DEVICE_CONTROL, std::move(status),
+    // onData
+    ResponseHandler::bind<&Dehumidifier::m_readResponse>(this),
+    // onSuccess
+    [this]() {
+      this->m_sendControl = false;
+    },
+    // onError
+    [this]() {
+      LOG_W(TAG, "SET_STATUS(0x48) request failed...");
+      this->m_sendControl = false;
+    },
+    PRIORITY_CONTROL
+  );
+}
+
+void Dehumidifier::setPowerState(bool state) {
+  Control control;
+  control.power = state;
+  this->control(control);
+}
+
+void Dehumidifier::m_onDecoded(uint8_t /*idx*/, const uint8_t *data, uint8_t /*size*/, DhState &/*state*/) {
+  LOG_D(TAG, "New status data received.");
+  this->m_status.copyStatus(data);
+}
+
+}  // namespace dh
+}  // namespace midea
+}  // namespace dudanov
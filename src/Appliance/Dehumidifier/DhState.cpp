@@ -0,0 +1,32 @@
+#include "Appliance/Dehumidifier/DhState.h"
+
+namespace dudanov {
+namespace midea {
+namespace dh {
+
+uint16_t DhState::diff(const DhState &other) const {
+  uint16_t mask = 0;
+  if (this->power != other.power)
+    mask |= CHANGE_POWER;
+  if (this->mode != other.mode)
+    mask |= CHANGE_MODE;
+  if (this->fanSpeed != other.fanSpeed)
+    mask |= CHANGE_FAN_SPEED;
+  if (this->targetHumidity != other.targetHumidity)
+    mask |= CHANGE_TARGET_HUMIDITY;
+  if (this->humidity != other.humidity)
+    mask |= CHANGE_HUMIDITY;
+  if (this->temperature != other.temperature)
+    mask |= CHANGE_TEMPERATURE;
+  if (this->tankLevel != other.tankLevel)
+    mask |= CHANGE_TANK_LEVEL;
+  if (this->ion != other.ion)
+    mask |= CHANGE_ION;
+  if (this->pump != other.pump)
+    mask |= CHANGE_PUMP;
+  return mask;
+}
+
+}  // namespace dh
+}  // namespace midea
+}  // namespace dudanov
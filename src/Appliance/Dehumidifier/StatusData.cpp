@@ -0,0 +1,31 @@
+#include "Appliance/Dehumidifier/StatusData.h"
+#include "Appliance/Dehumidifier/DhState.h"
+
+namespace dudanov {
+namespace midea {
+namespace dh {
+
+using Layout = StatusLayout;
+
+void StatusData::decodeAll(const uint8_t *data, uint8_t size, DhState &state) {
+  // Short payloads are padded with zeros, so fields are read without bounds checking
+  uint8_t buf[Layout::SIZE]{};
+  if (size < Layout::SIZE) {
+    std::copy(data, data + size, buf);
+    data = buf;
+  }
+  state.power = Layout::Power::get(data);
+  state.mode = static_cast<Mode>(Layout::Mode::get(data));
+  state.fanSpeed = static_cast<FanSpeed>(Layout::FanSpeed::get(data));
+  state.targetHumidity = Layout::TargetHumidity::get(data);
+  state.humidity = Layout::Humidity::get(data);
+  // Half degrees with +25 °C offset
+  state.temperature = (static_cast<int16_t>(Layout::Temperature::get(data)) - 50) * 5;
+  state.tankLevel = Layout::TankLevel::get(data);
+  state.ion = Layout::Ion::get(data);
+  state.pump = Layout::Pump::get(data);
+}
+
+}  // namespace dh
+}  // namespace midea
+}  // namespace dudanov
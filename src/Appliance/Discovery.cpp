@@ -0,0 +1,88 @@
+#include "Appliance/Discovery.h"
+#include "Helpers/Helpers.h"
+#include "Helpers/Log.h"
+#include <algorithm>
+
+namespace dudanov {
+namespace midea {
+
+static const char *TAG = "Discovery";
+static const uint8_t SERIALIZED_MAGIC[] = {'M', 'D'};
+static const uint8_t SERIALIZED_VERSION = 1;
+
+size_t ApplianceInfo::serialize(uint8_t *data, size_t size) const {
+  if (size < SERIALIZED_SIZE)
+    return 0;
+  uint8_t *it = std::copy(SERIALIZED_MAGIC, SERIALIZED_MAGIC + sizeof(SERIALIZED_MAGIC), data);
+  *it++ = SERIALIZED_VERSION;
+  *it++ = this->type;
+  *it++ = this->protocol;
+  *it++ = this->serialSize;
+  it = std::copy(this->serialNumber, this->serialNumber + MAX_SERIAL_SIZE, it);
+  putU32(it, fnv1a(data, it - data));
+  return SERIALIZED_SIZE;
+}
+
+bool ApplianceInfo::deserialize(const uint8_t *data, size_t size) {
+  if (size < SERIALIZED_SIZE || !std::equal(SERIALIZED_MAGIC, SERIALIZED_MAGIC + sizeof(SERIALIZED_MAGIC), data) ||
+      data[2] != SERIALIZED_VERSION || data[5] > MAX_SERIAL_SIZE ||
+      getU32(data + SERIALIZED_SIZE - 4) != fnv1a(data, SERIALIZED_SIZE - 4))
+    return false;
+  this->type = static_cast<ApplianceType>(data[3]);
+  this->protocol = data[4];
+  this->serialSize = data[5];
+  std::copy(data + 6, data + 6 + MAX_SERIAL_SIZE, this->serialNumber);
+  return true;
+}
+
+class GetElectronicIdData : public FrameData {
+ public:
+  GetElectronicIdData() : FrameData({0x00}) { this->appendCRC(); }
+};
+
+void Discovery::m_setup() {
+  this->m_addRoute(FrameType::GET_ELECTRONIC_ID, FrameHandler::bind<&Discovery::m_onElectronicID>(this));
+  if (this->m_storage == nullptr || this->m_force)
+    return;
+  uint8_t data[ApplianceInfo::SERIALIZED_SIZE];
+  const size_t size = this->m_storage->load(this->m_key, data, sizeof(data));
+  if (!this->m_info.deserialize(data, size))
+    return;
+  LOG_I(TAG, "Appliance 0x%02X restored from cache.", this->m_info.type);
+  this->m_isDone = true;
+  this->m_setReady();
+  this->m_callbacks.call(this->m_info);
+}
+
+void Discovery::m_onIdle() {
+  if (this->m_isDone)
+    return;
+  LOG_D(TAG, "Sending GET_ELECTRONIC_ID(0x07) broadcast...");
+  this->m_sendFrame(FrameType::GET_ELECTRONIC_ID, GetElectronicIdData{});
+}
+
+void Discovery::m_onElectronicID(const Frame &frame) {
+  // Appliance answers with its own type in header
+  if (this->m_isDone || frame.getAppliance() == BROADCAST)
+    return;
+  this->m_info.type = static_cast<ApplianceType>(frame.getAppliance());
+  this->m_info.protocol = frame.getProtocol();
+  // Payload without CRC
+  const uint8_t size = frame.getPayloadSize() ? frame.getPayloadSize() - 1 : 0;
+  this->m_info.serialSize = (size < ApplianceInfo::MAX_SERIAL_SIZE) ? size : ApplianceInfo::MAX_SERIAL_SIZE;
+  std::fill(this->m_info.serialNumber, this->m_info.serialNumber + ApplianceInfo::MAX_SERIAL_SIZE, 0);
+  std::copy(frame.getPayload(), frame.getPayload() + this->m_info.serialSize, this->m_info.serialNumber);
+  LOG_I(TAG, "Found appliance 0x%02X, protocol %u.", this->m_info.type, this->m_info.protocol);
+  this->m_isDone = true;
+  this->m_setReady();
+  if (this->m_storage != nullptr) {
+    uint8_t data[ApplianceInfo::SERIALIZED_SIZE];
+    const size_t size = this->m_info.serialize(data, sizeof(data));
+    if (!this->m_storage->save(this->m_key, data, size))
+      LOG_W(TAG, "Failed to save discovery result.");
+  }
+  this->m_callbacks.call(this->m_info);
+}
+
+}  // namespace midea
+}  // namespace dudanov
@@ -0,0 +1,34 @@
+#include "Appliance/MemoryReport.h"
+#include "Helpers/Log.h"
+
+namespace dudanov {
+namespace midea {
+
+static const char *TAG = "Memory";
+
+void dumpMemory(const ApplianceBase *appliance) {
+  LOG_CONFIG(TAG, "MEMORY REPORT:");
+  LOG_CONFIG(TAG, "  Static sizes, bytes:");
+  for (const auto &item : CLASS_SIZES)
+    LOG_CONFIG(TAG, "    %-20s %u", item.name, static_cast<unsigned>(item.size));
+  if (appliance != nullptr) {
+    const MemoryUsage usage = appliance->getMemoryUsage();
+    LOG_CONFIG(TAG, "  Appliance heap: %u bytes (requests: %u, buffers: %u, callbacks: %u)",
+               static_cast<unsigned>(usage.total()), static_cast<unsigned>(usage.requests),
+               static_cast<unsigned>(usage.buffers), static_cast<unsigned>(usage.callbacks));
+  }
+  if (!AllocTracker::isEnabled())
+    return;
+  const AllocStats stats = AllocTracker::getStats();
+  LOG_CONFIG(TAG, "  Allocations: %u, frees: %u, live: %u bytes, peak: %u bytes", static_cast<unsigned>(stats.numAllocs),
+             static_cast<unsigned>(stats.numFrees), static_cast<unsigned>(stats.bytes),
+             static_cast<unsigned>(stats.peakBytes));
+  for (uint8_t idx = 0; idx < AllocTracker::getNumSites(); ++idx) {
+    const AllocSite &site = AllocTracker::getSite(idx);
+    LOG_CONFIG(TAG, "    %p: %u allocations, %u bytes", site.address, static_cast<unsigned>(site.numAllocs),
+               static_cast<unsigned>(site.bytes));
+  }
+}
+
+}  // namespace midea
+}  // namespace dudanov
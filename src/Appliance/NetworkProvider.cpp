@@ -0,0 +1,60 @@
+#include "Appliance/NetworkProvider.h"
+#if defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_ESP8266)
+#ifdef ARDUINO_ARCH_ESP32
+#include <WiFi.h>
+#else
+#include <ESP8266WiFi.h>
+#endif
+
+namespace dudanov {
+namespace midea {
+
+// Written from WiFi event context
+static volatile uint32_t s_revision;
+static bool s_isRegistered;
+
+#ifdef ARDUINO_ARCH_ESP32
+static void onWiFiEvent(WiFiEvent_t event) { s_revision = s_revision + 1; }
+#elif defined(ARDUINO_ARCH_ESP8266)
+static WiFiEventHandler s_gotIpHandler;
+static WiFiEventHandler s_disconnectedHandler;
+#endif
+
+// Events are registered on first use, when WiFi is initialized
+static void registerEvents() {
+  if (s_isRegistered)
+    return;
+  s_isRegistered = true;
+#ifdef ARDUINO_ARCH_ESP32
+  WiFi.onEvent(onWiFiEvent);
+#elif defined(ARDUINO_ARCH_ESP8266)
+  s_gotIpHandler = WiFi.onStationModeGotIP([](const WiFiEventStationModeGotIP &) { s_revision = s_revision + 1; });
+  s_disconnectedHandler =
+      WiFi.onStationModeDisconnected([](const WiFiEventStationModeDisconnected &) { s_revision = s_revision + 1; });
+#endif
+}
+
+uint32_t WiFiProvider::getRevision() {
+  registerEvents();
+  return s_revision;
+}
+
+static uint8_t getSignalStrength() {
+  const int32_t dbm = WiFi.RSSI();
+  if (dbm > -63)
+    return 4;
+  if (dbm > -75)
+    return 3;
+  if (dbm > -88)
+    return 2;
+  return 1;
+}
+
+NetworkStatus WiFiProvider::getStatus() {
+  const IPAddress ip = WiFi.localIP();
+  return {{ip[0], ip[1], ip[2], ip[3]}, getSignalStrength(), WiFi.isConnected()};
+}
+
+}  // namespace midea
+}  // namespace dudanov
+#endif
@@ -38,6 +38,11 @@ uint8_t FrameData::m_getValue(uint8_t idx, uint8_t mask, uint8_t shift) const {
 }
 
 void NetworkNotifyData::setIP(const IPAddress &ip) {
+  const uint8_t data[] = {ip[0], ip[1], ip[2], ip[3]};
+  this->setIP(data);
+}
+
+void NetworkNotifyData::setIP(const uint8_t *ip) {
   this->m_data[3] = ip[3];
   this->m_data[4] = ip[2];
   this->m_data[5] = ip[1];
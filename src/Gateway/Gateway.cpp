@@ -0,0 +1,143 @@
+#include "Gateway/Gateway.h"
+#if defined(__linux__) && !defined(ARDUINO)
+#include "Helpers/Log.h"
+#include <algorithm>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace dudanov {
+namespace midea {
+
+static const char *TAG = "Gateway";
+
+Gateway::Gateway() : m_epoll(epoll_create1(EPOLL_CLOEXEC)) {
+  if (this->m_epoll < 0)
+    LOG_W(TAG, "Failed to create epoll instance.");
+}
+
+Gateway::~Gateway() {
+  for (auto device : this->m_devices)
+    delete device;
+  if (this->m_epoll >= 0)
+    close(this->m_epoll);
+}
+
+bool Gateway::add(ApplianceBase &appliance, int fd) {
+  auto device = new Device{};
+  if (!device->transport.open(fd)) {
+    delete device;
+    return false;
+  }
+  return this->m_add(appliance, device);
+}
+
+bool Gateway::addSerial(ApplianceBase &appliance, const char *path) {
+  auto device = new Device{};
+  if (!device->transport.openSerial(path)) {
+    delete device;
+    return false;
+  }
+  return this->m_add(appliance, device);
+}
+
+bool Gateway::m_add(ApplianceBase &appliance, Device *device) {
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.ptr = device;
+  if (this->m_epoll < 0 || this->m_find(appliance) != nullptr ||
+      epoll_ctl(this->m_epoll, EPOLL_CTL_ADD, device->transport.getFd(), &event)) {
+    LOG_W(TAG, "Failed to add appliance.");
+    delete device;
+    return false;
+  }
+  device->appliance = &appliance;
+  this->m_devices.push_back(device);
+  if (this->m_memoryBudget)
+    appliance.setMemoryBudget(this->m_memoryBudget);
+  appliance.setTransport(&device->transport);
+  appliance.setup();
+  this->m_run(*device);
+  return true;
+}
+
+void Gateway::remove(ApplianceBase &appliance) {
+  Device *device = this->m_find(appliance);
+  if (device == nullptr)
+    return;
+  this->m_wheel.cancel(*device);
+  this->m_devices.erase(std::find(this->m_devices.begin(), this->m_devices.end(), device));
+  // Closed descriptor leaves epoll set by itself
+  if (!this->m_isDispatching) {
+    delete device;
+    return;
+  }
+  device->transport.close();
+  device->appliance = nullptr;
+  this->m_removed.push_back(device);
+}
+
+void Gateway::wake(ApplianceBase &appliance) {
+  Device *device = this->m_find(appliance);
+  if (device != nullptr)
+    this->m_wheel.schedule(*device, TimerManager::ms());
+}
+
+Gateway::Device *Gateway::m_find(const ApplianceBase &appliance) const {
+  for (auto device : this->m_devices)
+    if (device->appliance == &appliance)
+      return device;
+  return nullptr;
+}
+
+unsigned Gateway::poll(int timeout) {
+  TimerTick now = TimerManager::update();
+  const uint32_t delay = this->m_wheel.getDelay(now, (timeout < 0) ? UINT32_MAX : timeout);
+  epoll_event events[MAX_EVENTS];
+  const int num = epoll_wait(this->m_epoll, events, MAX_EVENTS, (delay == UINT32_MAX) ? -1 : static_cast<int>(delay));
+  now = TimerManager::update();
+  unsigned count = 0;
+  this->m_isDispatching = true;
+  for (int n = 0; n < num; ++n) {
+    Device *device = static_cast<Device *>(events[n].data.ptr);
+    if (device->appliance != nullptr) {
+      this->m_run(*device);
+      ++count;
+    }
+  }
+  // Removed devices are cancelled, so wheel holds live ones only
+  for (TimerWheel::Entry *entry; (entry = this->m_wheel.pop(now)) != nullptr; ++count)
+    this->m_run(*static_cast<Device *>(entry));
+  this->m_isDispatching = false;
+  for (auto device : this->m_removed)
+    delete device;
+  this->m_removed.clear();
+  return count;
+}
+
+void Gateway::run() {
+  for (this->m_isRunning = true; this->m_isRunning;)
+    this->poll();
+}
+
+void Gateway::m_run(Device &device) {
+  device.appliance->loop();
+  // Removed by its own callback
+  if (device.appliance == nullptr)
+    return;
+  // Deadlines are rounded up to wheel resolution, so due appliance never runs twice per iteration
+  const uint32_t delay = std::max<uint32_t>(device.appliance->getWakeDelay(), 1);
+  this->m_wheel.schedule(device, TimerManager::ms() + delay);
+  // Rest of output is sent when descriptor becomes writable
+  const bool isWriting = device.transport.getPending() != 0;
+  if (isWriting == device.isWriting || !device.transport.isOpen())
+    return;
+  epoll_event event{};
+  event.events = isWriting ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+  event.data.ptr = &device;
+  if (!epoll_ctl(this->m_epoll, EPOLL_CTL_MOD, device.transport.getFd(), &event))
+    device.isWriting = isWriting;
+}
+
+}  // namespace midea
+}  // namespace dudanov
+#endif
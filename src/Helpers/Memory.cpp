@@ -0,0 +1,77 @@
+#include "Helpers/Memory.h"
+#if defined(MIDEA_TRACK_ALLOCATIONS) && !defined(ARDUINO)
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace dudanov {
+
+static AllocStats s_stats{};
+static AllocSite s_sites[AllocTracker::MAX_SITES]{};
+static uint8_t s_numSites{};
+
+#if defined(MIDEA_TRACK_ALLOCATIONS) && !defined(ARDUINO)
+
+bool AllocTracker::isEnabled() { return true; }
+
+// Block header keeps its size. Alignment of `malloc()` is preserved.
+static const size_t HEADER_SIZE = alignof(std::max_align_t);
+
+static void *allocate(size_t size, const void *address) {
+  uint8_t *const block = static_cast<uint8_t *>(std::malloc(HEADER_SIZE + size));
+  if (block == nullptr)
+    throw std::bad_alloc();
+  *reinterpret_cast<size_t *>(block) = size;
+  ++s_stats.numAllocs;
+  s_stats.bytes += size;
+  if (s_stats.bytes > s_stats.peakBytes)
+    s_stats.peakBytes = s_stats.bytes;
+  uint8_t idx = 0;
+  while (idx < s_numSites && s_sites[idx].address != address)
+    ++idx;
+  if (idx == s_numSites && s_numSites < AllocTracker::MAX_SITES)
+    s_sites[s_numSites++] = {address, 0, 0};
+  if (idx < s_numSites) {
+    ++s_sites[idx].numAllocs;
+    s_sites[idx].bytes += size;
+  }
+  return block + HEADER_SIZE;
+}
+
+static void release(void *ptr) {
+  if (ptr == nullptr)
+    return;
+  uint8_t *const block = static_cast<uint8_t *>(ptr) - HEADER_SIZE;
+  ++s_stats.numFrees;
+  s_stats.bytes -= *reinterpret_cast<size_t *>(block);
+  std::free(block);
+}
+
+#else
+
+bool AllocTracker::isEnabled() { return false; }
+
+#endif
+
+void AllocTracker::reset() {
+  s_stats = {0, 0, s_stats.bytes, s_stats.bytes};
+  s_numSites = 0;
+}
+
+AllocStats AllocTracker::getStats() { return s_stats; }
+
+uint8_t AllocTracker::getNumSites() { return s_numSites; }
+
+const AllocSite &AllocTracker::getSite(uint8_t idx) { return s_sites[idx]; }
+
+}  // namespace dudanov
+
+#if defined(MIDEA_TRACK_ALLOCATIONS) && !defined(ARDUINO)
+// Replaced global allocation functions. Nothrow and aligned versions use them or are not tracked.
+void *operator new(size_t size) { return dudanov::allocate(size, __builtin_return_address(0)); }
+void *operator new[](size_t size) { return dudanov::allocate(size, __builtin_return_address(0)); }
+void operator delete(void *ptr) noexcept { dudanov::release(ptr); }
+void operator delete[](void *ptr) noexcept { dudanov::release(ptr); }
+void operator delete(void *ptr, size_t) noexcept { dudanov::release(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { dudanov::release(ptr); }
+#endif
@@ -0,0 +1,34 @@
+#include "Helpers/RttEstimator.h"
+
+namespace dudanov {
+
+void RttEstimator::addSample(uint32_t rtt) {
+  this->m_last = rtt;
+  if (rtt < this->m_min)
+    this->m_min = rtt;
+  if (rtt > this->m_max)
+    this->m_max = rtt;
+  if (!this->m_numSamples++) {
+    this->m_srtt = rtt << 3;
+    this->m_rttvar = rtt << 1;
+    return;
+  }
+  // SRTT += (RTT - SRTT) / 8
+  int32_t err = static_cast<int32_t>(rtt) - static_cast<int32_t>(this->m_srtt >> 3);
+  this->m_srtt += err;
+  // RTTVAR += (|RTT - SRTT| - RTTVAR) / 4
+  if (err < 0)
+    err = -err;
+  this->m_rttvar += err - static_cast<int32_t>(this->m_rttvar >> 2);
+}
+
+uint32_t RttEstimator::getTimeout(uint32_t min, uint32_t max) const {
+  const uint32_t timeout = (this->m_srtt >> 3) + this->m_rttvar;
+  if (timeout < min)
+    return min;
+  if (timeout > max)
+    return max;
+  return timeout;
+}
+
+}  // namespace dudanov
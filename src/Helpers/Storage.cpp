@@ -0,0 +1,86 @@
+#include "Helpers/Storage.h"
+#include <cstdio>
+#ifdef ARDUINO_ARCH_ESP32
+#include <Preferences.h>
+#endif
+#ifdef ARDUINO_ARCH_ESP8266
+#include <LittleFS.h>
+#endif
+
+namespace dudanov {
+
+String FileStorage::m_path(const char *key) const {
+  String path(this->m_dir);
+  path += "/";
+  path += key;
+  return path;
+}
+
+size_t FileStorage::load(const char *key, uint8_t *data, size_t size) {
+  FILE *file = fopen(this->m_path(key).c_str(), "rb");
+  if (file == nullptr)
+    return 0;
+  const size_t read = fread(data, 1, size, file);
+  fclose(file);
+  return read;
+}
+
+bool FileStorage::save(const char *key, const uint8_t *data, size_t size) {
+  FILE *file = fopen(this->m_path(key).c_str(), "wb");
+  if (file == nullptr)
+    return false;
+  const bool ok = fwrite(data, 1, size, file) == size;
+  return fclose(file) == 0 && ok;
+}
+
+#ifdef ARDUINO_ARCH_ESP8266
+bool LittleFsStorage::m_mount() {
+  if (!this->m_isMounted && LittleFS.begin())
+    this->m_isMounted = LittleFS.exists(this->m_dir) || LittleFS.mkdir(this->m_dir);
+  return this->m_isMounted;
+}
+
+size_t LittleFsStorage::load(const char *key, uint8_t *data, size_t size) {
+  if (!this->m_mount())
+    return 0;
+  File file = LittleFS.open(this->m_path(key), "r");
+  if (!file)
+    return 0;
+  const size_t read = file.read(data, size);
+  file.close();
+  return read;
+}
+
+bool LittleFsStorage::save(const char *key, const uint8_t *data, size_t size) {
+  if (!this->m_mount())
+    return false;
+  File file = LittleFS.open(this->m_path(key), "w");
+  if (!file)
+    return false;
+  const bool ok = file.write(data, size) == size;
+  file.close();
+  return ok;
+}
+#endif
+
+#ifdef ARDUINO_ARCH_ESP32
+size_t NvsStorage::load(const char *key, uint8_t *data, size_t size) {
+  Preferences prefs;
+  if (!prefs.begin(this->m_name, true))
+    return 0;
+  const size_t read = prefs.getBytes(key, data, size);
+  prefs.end();
+  return read;
+}
+
+bool NvsStorage::save(const char *key, const uint8_t *data, size_t size) {
+  Preferences prefs;
+  if (!prefs.begin(this->m_name, false))
+    return false;
+  const bool ok = prefs.putBytes(key, data, size) == size;
+  prefs.end();
+  return ok;
+}
+#endif
+
+}  // namespace dudanov
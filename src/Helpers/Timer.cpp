@@ -9,12 +9,22 @@ TimerTick TimerManager::s_millis;
 static void dummy(Timer *timer) { timer->stop(); }
 Timer::Timer() : m_callback(dummy), m_alarm(0) {}
 
+TimerTick TimerManager::update() { return s_millis = ::millis(); }
+
 /// Timers task. Must be periodically called in loop function.
 void TimerManager::task() {
-  s_millis = ::millis();
+  TimerManager::update();
   for (auto timer : m_timers)
     if (timer->isEnabled() && timer->isExpired())
       timer->call();
 }
 
+uint32_t TimerManager::getDelay() const {
+  uint32_t delay = UINT32_MAX;
+  for (auto timer : m_timers)
+    if (timer->isEnabled() && timer->remaining() < delay)
+      delay = timer->remaining();
+  return delay;
+}
+
 }  // namespace dudanov
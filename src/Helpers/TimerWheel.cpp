@@ -0,0 +1,60 @@
+#include "Helpers/TimerWheel.h"
+
+namespace dudanov {
+
+void TimerWheel::schedule(Entry &entry, TimerTick deadline) {
+  this->cancel(entry);
+  entry.deadline = deadline;
+  entry.isScheduled = true;
+  // Past deadline goes to current slot
+  entry.slot = m_index(static_cast<long>(deadline - this->m_time) < 0 ? this->m_time : deadline);
+  Entry *&head = this->m_slots[entry.slot];
+  entry.prev = nullptr;
+  entry.next = head;
+  if (head != nullptr)
+    head->prev = &entry;
+  head = &entry;
+  ++this->m_size;
+}
+
+void TimerWheel::cancel(Entry &entry) {
+  if (!entry.isScheduled)
+    return;
+  if (entry.prev != nullptr)
+    entry.prev->next = entry.next;
+  else
+    this->m_slots[entry.slot] = entry.next;
+  if (entry.next != nullptr)
+    entry.next->prev = entry.prev;
+  entry.isScheduled = false;
+  --this->m_size;
+}
+
+TimerWheel::Entry *TimerWheel::pop(TimerTick now) {
+  // After long pause one revolution covers all slots
+  if (now - this->m_time >= NUM_SLOTS && static_cast<long>(now - this->m_time) > 0)
+    this->m_time = now - (NUM_SLOTS - 1);
+  while (true) {
+    for (Entry *entry = this->m_slots[m_index(this->m_time)]; entry != nullptr; entry = entry->next) {
+      if (static_cast<long>(entry->deadline - now) <= 0) {
+        this->cancel(*entry);
+        return entry;
+      }
+    }
+    if (static_cast<long>(now - this->m_time) <= 0)
+      return nullptr;
+    ++this->m_time;
+  }
+}
+
+uint32_t TimerWheel::getDelay(TimerTick now, uint32_t max) const {
+  const uint32_t limit = (max < NUM_SLOTS) ? max : NUM_SLOTS;
+  for (uint32_t delay = 0; delay < limit; ++delay)
+    for (const Entry *entry = this->m_slots[m_index(now + delay)]; entry != nullptr; entry = entry->next)
+      if (static_cast<long>(entry->deadline - now) <= static_cast<long>(delay))
+        return delay;
+  // Nothing within one revolution: wake up to look again
+  return limit;
+}
+
+}  // namespace dudanov
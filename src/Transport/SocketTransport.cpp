@@ -0,0 +1,161 @@
+#include "Transport/SocketTransport.h"
+#if !defined(ARDUINO) && (defined(__unix__) || defined(__APPLE__))
+#include "Helpers/Log.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace dudanov {
+namespace midea {
+
+static const char *TAG = "SocketTransport";
+
+bool SocketTransport::open(int fd) {
+  this->close();
+  if (fd < 0)
+    return false;
+  const int flags = fcntl(fd, F_GETFL, 0);
+  if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+    ::close(fd);
+    return false;
+  }
+  int type;
+  socklen_t len = sizeof(type);
+  this->m_isSocket = !getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &len);
+  this->m_fd = fd;
+  return true;
+}
+
+bool SocketTransport::openSerial(const char *path) {
+  const int fd = ::open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (fd < 0) {
+    LOG_W(TAG, "Failed to open %s.", path);
+    return false;
+  }
+  termios tty;
+  if (!tcgetattr(fd, &tty)) {
+    cfmakeraw(&tty);
+    cfsetispeed(&tty, B9600);
+    cfsetospeed(&tty, B9600);
+    tty.c_cflag &= ~(CSTOPB | PARENB);
+    tty.c_cflag |= CLOCAL | CREAD;
+    tcsetattr(fd, TCSANOW, &tty);
+  }
+  return this->open(fd);
+}
+
+void SocketTransport::close() {
+  if (this->m_fd < 0)
+    return;
+  ::close(this->m_fd);
+  this->m_fd = -1;
+  this->m_rxPos = this->m_rxLen = 0;
+  this->m_txLen = 0;
+}
+
+bool SocketTransport::m_connect(const char *host, uint16_t port, bool udp) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = udp ? SOCK_DGRAM : SOCK_STREAM;
+  char service[6];
+  snprintf(service, sizeof(service), "%u", port);
+  addrinfo *result;
+  if (getaddrinfo(host, service, &hints, &result)) {
+    LOG_W(TAG, "Failed to resolve %s.", host);
+    return false;
+  }
+  int fd = -1;
+  for (addrinfo *ai = result; ai != nullptr; ai = ai->ai_next) {
+    fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd < 0)
+      continue;
+    // Blocking connect: gateway connects once on start
+    if (!connect(fd, ai->ai_addr, ai->ai_addrlen))
+      break;
+    ::close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(result);
+  if (fd < 0) {
+    LOG_W(TAG, "Failed to connect to %s:%u.", host, port);
+    return false;
+  }
+  if (!udp) {
+    // Frames are batched by flush(), so Nagle's delay is useless
+    const int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  }
+  return this->open(fd);
+}
+
+size_t SocketTransport::read(uint8_t *data, size_t size) {
+  if (this->m_rxPos == this->m_rxLen) {
+    if (this->m_fd < 0)
+      return 0;
+    const ssize_t num = ::read(this->m_fd, this->m_rxBuf, RX_BUFFER_SIZE);
+    if (num <= 0) {
+      if (num < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        return 0;
+      LOG_W(TAG, "Connection closed.");
+      this->close();
+      return 0;
+    }
+    this->m_rxPos = 0;
+    this->m_rxLen = num;
+  }
+  if (size > this->m_rxLen - this->m_rxPos)
+    size = this->m_rxLen - this->m_rxPos;
+  memcpy(data, this->m_rxBuf + this->m_rxPos, size);
+  this->m_rxPos += size;
+  return size;
+}
+
+size_t SocketTransport::m_send(const uint8_t *data, size_t size) {
+  const ssize_t num = this->m_isSocket ? send(this->m_fd, data, size, MSG_NOSIGNAL) : ::write(this->m_fd, data, size);
+  if (num >= 0)
+    return num;
+  if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+    LOG_W(TAG, "Write failed.");
+    this->close();
+  }
+  return 0;
+}
+
+size_t SocketTransport::write(const uint8_t *data, size_t size) {
+  if (this->m_fd < 0)
+    return 0;
+  if (this->m_txLen + size > TX_BUFFER_SIZE) {
+    this->flush();
+    // Part of frame must never be sent
+    if (this->m_fd < 0 || this->m_txLen + size > TX_BUFFER_SIZE) {
+      LOG_W(TAG, "Send buffer is full. Frame is dropped.");
+      return 0;
+    }
+  }
+  memcpy(this->m_txBuf + this->m_txLen, data, size);
+  this->m_txLen += size;
+  return size;
+}
+
+void SocketTransport::flush() {
+  if (this->m_fd < 0 || !this->m_txLen)
+    return;
+  const size_t num = this->m_send(this->m_txBuf, this->m_txLen);
+  if (num && num < this->m_txLen)
+    memmove(this->m_txBuf, this->m_txBuf + num, this->m_txLen - num);
+  if (this->m_fd >= 0)
+    this->m_txLen -= num;
+}
+
+}  // namespace midea
+}  // namespace dudanov
+#endif
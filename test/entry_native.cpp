@@ -1 +1,3 @@
-extern "C" int main() {}
\ No newline at end of file
+#ifndef PIO_UNIT_TESTING
+extern "C" int main() {}
+#endif
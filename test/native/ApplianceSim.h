@@ -0,0 +1,220 @@
+#pragma once
+#include <Arduino.h>
+
+/// Simulated appliance on other end of UART. Collects request frames written by library, passes them to
+/// `m_onRequest()` and delivers queued responses after their latency, earliest first. Uses no heap.
+class ApplianceSim : public Stream {
+ public:
+  static const uint8_t MAX_FRAME = 64;
+  static const uint8_t MAX_PENDING = 8;
+  ApplianceSim(uint8_t appliance = 0xAC, uint8_t protocol = 3) : m_appliance(appliance), m_protocol(protocol) {}
+  /// Set response latency, ms
+  void setLatency(unsigned long latency) { this->m_latency = latency; }
+  /// Number of received request frames
+  uint32_t getNumRequests() const { return this->m_numRequests; }
+  /// Maximum number of responses waiting for delivery at once
+  uint8_t getMaxPending() const { return this->m_maxPending; }
+  /// Type and payload (CRC excluded) of last request
+  uint8_t getRequestType() const { return this->m_request[9]; }
+  const uint8_t *getRequestPayload() const { return this->m_request + 10; }
+  uint8_t getRequestPayloadSize() const { return this->m_request[1] - 11; }
+
+  int available() override {
+    const Pending *frame = this->m_next();
+    return (frame != nullptr) ? frame->size - frame->pos : 0;
+  }
+
+  int read() override {
+    Pending *frame = this->m_next();
+    if (frame == nullptr)
+      return -1;
+    const uint8_t data = frame->data[frame->pos++];
+    if (frame->pos == frame->size) {
+      frame->size = 0;
+      this->m_reading = nullptr;
+      --this->m_numPending;
+    }
+    return data;
+  }
+
+  size_t write(const uint8_t *data, size_t size) override {
+    for (size_t n = 0; n < size; ++n) {
+      if (this->m_size == 0 && data[n] != 0xAA)
+        continue;
+      this->m_request[this->m_size++] = data[n];
+      if (this->m_size > 1 && (this->m_request[1] >= MAX_FRAME || this->m_request[1] <= 11)) {
+        this->m_size = 0;
+        continue;
+      }
+      if (this->m_size > 10 && this->m_size == this->m_request[1] + 1u) {
+        this->m_size = 0;
+        ++this->m_numRequests;
+        this->m_onRequest(this->getRequestType(), this->getRequestPayload(), this->getRequestPayloadSize());
+      }
+    }
+    return size;
+  }
+
+  /// Queue response frame. CRC of payload and frame checksum are appended.
+  void reply(uint8_t type, const uint8_t *payload, uint8_t size) { this->reply(type, payload, size, this->m_latency); }
+  /// Queue response frame with its own latency
+  void reply(uint8_t type, const uint8_t *payload, uint8_t size, unsigned long latency) {
+    if (this->m_numPending >= MAX_PENDING || size + 12 > MAX_FRAME)
+      return;
+    Pending *it = this->m_pending;
+    while (it->size)
+      ++it;
+    Pending &frame = *it;
+    if (++this->m_numPending > this->m_maxPending)
+      this->m_maxPending = this->m_numPending;
+    const uint8_t header[] = {0xAA, static_cast<uint8_t>(size + 11), this->m_appliance, 0, 0, 0, 0, 0, this->m_protocol, type};
+    memcpy(frame.data, header, sizeof(header));
+    frame.data[3] = frame.data[1] ^ frame.data[2];
+    memcpy(frame.data + 10, payload, size);
+    frame.data[10 + size] = crc8(payload, size);
+    uint8_t cs = 0;
+    for (uint8_t n = 1; n < size + 11; ++n)
+      cs -= frame.data[n];
+    frame.data[size + 11] = cs;
+    frame.size = size + 12;
+    frame.pos = 0;
+    frame.time = millis() + latency;
+    frame.sequence = this->m_sequence++;
+  }
+
+  /// CRC-8/MAXIM of frame payload
+  static uint8_t crc8(const uint8_t *data, uint8_t size) {
+    uint8_t crc = 0;
+    while (size--) {
+      crc ^= *data++;
+      for (uint8_t bit = 0; bit < 8; ++bit)
+        crc = (crc & 1) ? (crc >> 1) ^ 0x8C : crc >> 1;
+    }
+    return crc;
+  }
+
+ protected:
+  /// Called on each request frame. Default: no answer.
+  virtual void m_onRequest(uint8_t type, const uint8_t *payload, uint8_t size) {}
+
+ private:
+  struct Pending {
+    unsigned long time;
+    // Queuing order of frames due at same time
+    uint32_t sequence;
+    uint8_t data[MAX_FRAME];
+    // 0: free
+    uint8_t size;
+    uint8_t pos;
+  };
+  // Frame being read or the earliest due one
+  Pending *m_next() {
+    if (this->m_reading != nullptr)
+      return this->m_reading;
+    for (Pending &frame : this->m_pending) {
+      if (!frame.size || static_cast<long>(millis() - frame.time) < 0)
+        continue;
+      if (this->m_reading == nullptr || static_cast<long>(frame.time - this->m_reading->time) < 0 ||
+          (frame.time == this->m_reading->time && frame.sequence < this->m_reading->sequence))
+        this->m_reading = &frame;
+    }
+    return this->m_reading;
+  }
+  Pending m_pending[MAX_PENDING]{};
+  Pending *m_reading{};
+  uint32_t m_sequence{};
+  uint8_t m_numPending{};
+  uint8_t m_maxPending{};
+  uint8_t m_request[MAX_FRAME]{};
+  uint8_t m_size{};
+  uint32_t m_numRequests{};
+  unsigned long m_latency{};
+  uint8_t m_appliance;
+  uint8_t m_protocol;
+};
+
+/// Air conditioner answering status, power usage, capabilities and control requests
+class AirConditionerSim : public ApplianceSim {
+ public:
+  /// Modes, temperatures and more capabilities in next frame
+  static constexpr uint8_t CAPABILITIES[] = {0xB5, 0x02, 0x14, 0x02, 0x01, 0x01, 0x25, 0x02, 0x07, 0x20,
+                                             0x3C, 0x20, 0x3C, 0x20, 0x3C, 0x00, 0x01, 0x00};
+  /// Swing modes, turbo preset and fan speed control
+  static constexpr uint8_t CAPABILITIES_NEXT[] = {0xB5, 0x03, 0x15, 0x02, 0x01, 0x01, 0x1A, 0x02,
+                                                  0x01, 0x01, 0x10, 0x02, 0x01, 0x01, 0x00, 0x00};
+  /// Indoor temperature byte of status: (T * 2) + 50
+  uint8_t indoorTemp{0x62};
+  /// Energy counter, 0.1 kWh
+  uint32_t powerUsage{1234};
+  /// Replies to first and second 0xB5 requests. `nullptr`: no answer.
+  const uint8_t *capabilities[2]{CAPABILITIES, CAPABILITIES_NEXT};
+  uint8_t capabilitiesSize[2]{sizeof(CAPABILITIES), sizeof(CAPABILITIES_NEXT)};
+  uint32_t numStatusQueries{};
+  uint32_t numCapabilitiesQueries{};
+  uint32_t numPowerQueries{};
+  uint32_t numDisplayToggles{};
+  uint32_t numControls{};
+  /// Number of first SET_STATUS(0x40) frames to answer. Later ones are ignored.
+  uint32_t maxAnsweredControls{UINT32_MAX};
+
+ protected:
+  void m_onRequest(uint8_t type, const uint8_t *payload, uint8_t size) override {
+    if (type == 0x03 && payload[0] == 0xB5) {
+      ++this->numCapabilitiesQueries;
+      // First request is {0xB5, 0x01, 0x11}
+      const uint8_t idx = (size == 3) ? 0 : 1;
+      if (this->capabilities[idx] != nullptr)
+        this->reply(0x03, this->capabilities[idx], this->capabilitiesSize[idx]);
+    } else if (type == 0x03 && payload[0] == 0x41 && payload[1] == 0x21) {
+      ++this->numPowerQueries;
+      uint8_t power[] = {0xC1, 0x21, 0x01, 0x44, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+      // BCD, most significant byte first
+      for (uint32_t n = 18, value = this->powerUsage; n >= 16; --n, value /= 100)
+        power[n] = ((value / 10 % 10) << 4) | (value % 10);
+      this->reply(0x03, power, sizeof(power));
+    } else if (type == 0x03 && payload[0] == 0x41 && payload[1] == 0x61) {
+      ++this->numDisplayToggles;
+      this->m_replyStatus(0x03);
+    } else if (type == 0x03 && payload[0] == 0x41) {
+      ++this->numStatusQueries;
+      this->m_replyStatus(0x03);
+    } else if (type == 0x02 && payload[0] == 0x40) {
+      if (++this->numControls <= this->maxAnsweredControls)
+        this->m_replyStatus(0x02);
+    }
+  }
+  void m_replyStatus(uint8_t type) {
+    uint8_t status[] = {0xC0, 0x01, 0x45, 0x66, 0x7F, 0x7F, 0, 0x30, 0, 0, 0, 0, 0x55, 0, 0, 0x23, 0, 0, 0, 0, 0, 0, 0, 0};
+    status[11] = this->indoorTemp;
+    this->reply(type, status, sizeof(status));
+  }
+};
+
+/// Dehumidifier answering status and control requests. Control applies writable bytes to status.
+class DehumidifierSim : public ApplianceSim {
+ public:
+  DehumidifierSim() : ApplianceSim(0xA1, 3) {}
+  /// 0xC8 status payload: power, setpoint mode, high fan, 50 % setpoint, ion, full tank, 62 % at 20 °C
+  uint8_t status[24]{0xC8, 0x01, 0x01, 0x50, 0, 0, 0, 0x32, 0, 0x40, 0x64, 0, 0, 0, 0, 0, 0x3E, 0x5A};
+  /// Payload of last SET_STATUS(0x48) frame
+  uint8_t control[MAX_FRAME]{};
+  uint8_t controlSize{};
+  uint32_t numStatusQueries{};
+  uint32_t numControls{};
+
+ protected:
+  void m_onRequest(uint8_t type, const uint8_t *payload, uint8_t size) override {
+    if (type == 0x03 && payload[0] == 0x41) {
+      ++this->numStatusQueries;
+      this->reply(0x03, this->status, sizeof(this->status));
+    } else if (type == 0x02 && payload[0] == 0x48) {
+      ++this->numControls;
+      memcpy(this->control, payload, size);
+      this->controlSize = size;
+      // Beeper bits are not reported
+      this->status[1] = payload[1] & 0x01;
+      memcpy(this->status + 2, payload + 2, 8);
+      this->reply(0x02, this->status, sizeof(this->status));
+    }
+  }
+};
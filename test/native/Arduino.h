@@ -0,0 +1,88 @@
+#pragma once
+// Minimal Arduino API for native builds and unit tests
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *) (p))
+#define pgm_read_word(p) (*(const uint16_t *) (p))
+#define pgm_read_dword(p) (*(const uint32_t *) (p))
+#define memcpy_P memcpy
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+class String {
+ public:
+  String() = default;
+  String(const char *s) : m_str(s) {}
+  String(const __FlashStringHelper *s) : m_str(reinterpret_cast<const char *>(s)) {}
+  void reserve(size_t size) { m_str.reserve(size); }
+  String &operator+=(const char *s) {
+    m_str += s;
+    return *this;
+  }
+  String &operator+=(const String &s) {
+    m_str += s.m_str;
+    return *this;
+  }
+  size_t length() const { return m_str.size(); }
+  const char *c_str() const { return m_str.c_str(); }
+
+ private:
+  std::string m_str;
+};
+
+class Print {
+ public:
+  virtual ~Print() = default;
+  virtual size_t write(const uint8_t *buffer, size_t size) = 0;
+};
+
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+};
+
+/// Host clock. Monotonic time by default, tests may switch it to manual time.
+namespace host {
+inline bool g_isManualClock;
+inline unsigned long g_millis;
+/// Switch to manual clock and set its time, ms
+inline void setMillis(unsigned long ms) {
+  g_isManualClock = true;
+  g_millis = ms;
+}
+/// Advance manual clock, ms
+inline void advanceMillis(unsigned long ms) { setMillis(g_millis + ms); }
+/// Switch back to monotonic clock
+inline void useRealClock() { g_isManualClock = false; }
+}  // namespace host
+
+inline unsigned long millis() {
+  if (host::g_isManualClock)
+    return host::g_millis;
+  static const auto start = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline void delay(unsigned long ms) {
+  if (host::g_isManualClock)
+    host::advanceMillis(ms);
+  else
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline long random(long max) { return max > 0 ? std::rand() % max : 0; }
+inline long random(long min, long max) { return min + random(max - min); }
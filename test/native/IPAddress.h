@@ -0,0 +1,12 @@
+#pragma once
+#include <cstdint>
+
+class IPAddress {
+ public:
+  IPAddress() = default;
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : m_address{a, b, c, d} {}
+  uint8_t operator[](int idx) const { return m_address[idx]; }
+
+ private:
+  uint8_t m_address[4]{};
+};
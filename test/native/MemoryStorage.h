@@ -0,0 +1,29 @@
+#pragma once
+#include <Arduino.h>
+#include "Helpers/Storage.h"
+
+/// Storage of single blob in RAM. Keys are ignored.
+class MemoryStorage : public dudanov::Storage {
+ public:
+  static const size_t MAX_SIZE = 512;
+  size_t load(const char *key, uint8_t *data, size_t size) override {
+    const size_t num = size < this->size ? size : this->size;
+    memcpy(data, this->data, num);
+    return num;
+  }
+  bool save(const char *key, const uint8_t *data, size_t size) override {
+    if (size > MAX_SIZE)
+      return false;
+    memcpy(this->data, data, size);
+    this->size = size;
+    ++this->numSaves;
+    return true;
+  }
+  void clear() {
+    this->size = 0;
+    this->numSaves = 0;
+  }
+  uint8_t data[MAX_SIZE];
+  size_t size{};
+  uint32_t numSaves{};
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <fcntl.h>
+#include <unistd.h>
+#include "ApplianceSim.h"
+
+/// Connects simulated appliance to far end of descriptor pair: socketpair or pty.
+class SimLink {
+ public:
+  SimLink(ApplianceSim &sim, int fd) : m_sim(sim), m_fd(fd) { fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK); }
+  SimLink(const SimLink &) = delete;
+  SimLink &operator=(const SimLink &) = delete;
+  ~SimLink() { close(this->m_fd); }
+  /// Pass written requests to appliance and its due responses back
+  void pump() {
+    uint8_t buf[256];
+    ssize_t num;
+    while ((num = ::read(this->m_fd, buf, sizeof(buf))) > 0)
+      this->m_sim.write(buf, num);
+    size_t size = 0;
+    while (size < sizeof(buf) && this->m_sim.available())
+      buf[size++] = this->m_sim.read();
+    if (size && ::write(this->m_fd, buf, size) != static_cast<ssize_t>(size))
+      ++this->numLost;
+  }
+  int getFd() const { return this->m_fd; }
+  uint32_t numLost{};
+
+ protected:
+  ApplianceSim &m_sim;
+  int m_fd;
+};
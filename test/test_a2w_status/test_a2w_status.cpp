@@ -0,0 +1,104 @@
+// Heat pump 0xC3 bodies: decoding of known payloads, rejection of short bodies and unknown modes
+#include <unity.h>
+#include "Appliance/AirToWater/AirToWater.h"
+
+using namespace dudanov::midea;
+using namespace dudanov::midea::a2w;
+
+void test_basic_body() {
+  uint8_t data[BasicLayout::SIZE]{};
+  data[0] = BODY_BASIC;
+  // Zone 1 power, DHW power, zone 2 curve
+  data[1] = 0x01 | 0x04 | 0x10;
+  data[4] = MODE_COOL;
+  data[6] = 35;
+  data[7] = 28;
+  data[8] = 50;
+  data[9] = 44;
+  data[22] = 47;
+  data[23] = 5;
+  A2wState state;
+  TEST_ASSERT_TRUE(A2wDescriptor::decode(data, sizeof(data), state));
+  TEST_ASSERT_TRUE(state.zones[0].power);
+  TEST_ASSERT_FALSE(state.zones[0].curve);
+  TEST_ASSERT_EQUAL_UINT8(35, state.zones[0].targetTemp);
+  TEST_ASSERT_FALSE(state.zones[1].power);
+  TEST_ASSERT_TRUE(state.zones[1].curve);
+  TEST_ASSERT_EQUAL_UINT8(28, state.zones[1].targetTemp);
+  TEST_ASSERT_EQUAL_UINT8(MODE_COOL, state.mode);
+  TEST_ASSERT_TRUE(state.dhwPower);
+  TEST_ASSERT_EQUAL_UINT8(50, state.dhwTargetTemp);
+  TEST_ASSERT_EQUAL_UINT8(44, state.roomTargetTemp);
+  TEST_ASSERT_EQUAL_UINT8(47, state.dhwTemp);
+  TEST_ASSERT_EQUAL_UINT8(5, state.errorCode);
+  // Short body is rejected before any field is read
+  A2wState unchanged;
+  TEST_ASSERT_FALSE(A2wDescriptor::decode(data, sizeof(data) - 1, unchanged));
+  TEST_ASSERT_FALSE(unchanged.zones[0].power);
+}
+
+void test_unknown_mode_is_ignored() {
+  uint8_t data[BasicLayout::SIZE]{};
+  data[0] = BODY_BASIC;
+  data[4] = 0x07;
+  A2wState state;
+  state.mode = MODE_AUTO;
+  TEST_ASSERT_TRUE(StatusView(data, sizeof(data)).decode(state));
+  TEST_ASSERT_EQUAL_UINT8(MODE_AUTO, state.mode);
+  data[4] = 0;
+  TEST_ASSERT_TRUE(StatusView(data, sizeof(data)).decode(state));
+  TEST_ASSERT_EQUAL_UINT8(MODE_AUTO, state.mode);
+}
+
+void test_unit_body() {
+  const uint8_t data[] = {BODY_UNIT, 0x00, 60, 0x00, 0x00, 0x00, 0x00, 30, 0xFE};
+  A2wState state;
+  TEST_ASSERT_EQUAL_UINT8(UnitLayout::SIZE, sizeof(data));
+  TEST_ASSERT_TRUE(A2wDescriptor::decode(data, sizeof(data), state));
+  TEST_ASSERT_EQUAL_UINT8(60, state.compressorFrequency);
+  TEST_ASSERT_EQUAL_INT8(30, state.waterInTemp);
+  TEST_ASSERT_EQUAL_INT8(-2, state.waterOutTemp);
+  TEST_ASSERT_FALSE(A2wDescriptor::decode(data, sizeof(data) - 1, state));
+}
+
+void test_energy_body() {
+  const uint8_t data[] = {BODY_ENERGY, 0x00, 0x00, 0x01, 0x02, 0x03, 0x00, 0x00, 0x10, 0x00, 0xF6};
+  A2wState state;
+  TEST_ASSERT_EQUAL_UINT8(EnergyLayout::SIZE, sizeof(data));
+  TEST_ASSERT_TRUE(A2wDescriptor::decode(data, sizeof(data), state));
+  TEST_ASSERT_EQUAL_UINT32(0x010203, state.energyConsumed);
+  TEST_ASSERT_EQUAL_UINT32(0x1000, state.energyProduced);
+  TEST_ASSERT_EQUAL_INT8(-10, state.outdoorTemp);
+  TEST_ASSERT_FALSE(A2wDescriptor::decode(data, sizeof(data) - 1, state));
+}
+
+void test_unknown_body() {
+  const uint8_t data[32] = {0x05};
+  A2wState state;
+  TEST_ASSERT_FALSE(A2wDescriptor::decode(data, sizeof(data), state));
+  TEST_ASSERT_FALSE(A2wDescriptor::decode(data, 0, state));
+}
+
+void test_zone_bounds() {
+  AirToWater appliance;
+  // Single zone by default
+  TEST_ASSERT_EQUAL_PTR(&appliance.getZone(1), &appliance.getZone(200));
+  TEST_ASSERT_NOT_EQUAL(&appliance.getZone(0), &appliance.getZone(1));
+  TEST_ASSERT_FALSE(appliance.getZone(200).power);
+  appliance.setNumZones(2);
+  TEST_ASSERT_NOT_EQUAL(&appliance.getZone(1), &appliance.getZone(2));
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_basic_body);
+  RUN_TEST(test_unknown_mode_is_ignored);
+  RUN_TEST(test_unit_body);
+  RUN_TEST(test_energy_body);
+  RUN_TEST(test_unknown_body);
+  RUN_TEST(test_zone_bounds);
+  return UNITY_END();
+}
@@ -0,0 +1,134 @@
+// Capabilities cache: restore, background verification and replacement of changed capabilities
+#include <unity.h>
+#include "Appliance/AirConditioner/AirConditioner.h"
+#include "ApplianceSim.h"
+#include "MemoryStorage.h"
+
+using namespace dudanov;
+using namespace dudanov::midea;
+using namespace dudanov::midea::ac;
+
+// Turbo preset is not reported
+static const uint8_t CAPABILITIES_NO_TURBO[] = {0xB5, 0x03, 0x15, 0x02, 0x01, 0x01, 0x10, 0x02,
+                                                0x01, 0x01, 0x22, 0x02, 0x01, 0x01, 0x00, 0x00};
+static const uint8_t SERIAL[] = {'0', '0', '0', '1'};
+static const uint8_t OTHER_SERIAL[] = {'0', '0', '0', '2'};
+
+static MemoryStorage g_storage;
+
+static void run(AirConditioner &ac, unsigned long ms) {
+  for (unsigned long n = 0; n < ms; ++n) {
+    host::advanceMillis(1);
+    ac.loop();
+  }
+}
+
+static void start(AirConditioner &ac, AirConditionerSim &sim, const uint8_t *serial = nullptr) {
+  ac.setStream(&sim);
+  ac.setAutoconf(true);
+  ac.setCapabilitiesStorage(&g_storage);
+  if (serial != nullptr)
+    ac.setSerialNumber(serial, sizeof(SERIAL));
+  ac.setup();
+}
+
+// Fill cache by appliance with turbo preset
+static void fillCache(const uint8_t *serial = nullptr) {
+  AirConditionerSim sim;
+  AirConditioner ac;
+  start(ac, sim, serial);
+  run(ac, 10000);
+  TEST_ASSERT_EQUAL_UINT32(2, sim.numCapabilitiesQueries);
+  TEST_ASSERT_EQUAL(AUTOCONF_OK, ac.getAutoconfStatus());
+  TEST_ASSERT_TRUE(ac.getCapabilities().has(CAPABILITY_PRESET_TURBO));
+  TEST_ASSERT_EQUAL_UINT32(1, g_storage.numSaves);
+}
+
+void test_fill_cache() { fillCache(); }
+
+void test_unchanged_capabilities_are_kept() {
+  fillCache();
+  AirConditionerSim sim;
+  AirConditioner ac;
+  start(ac, sim);
+  // Available at once, before any answer
+  TEST_ASSERT_EQUAL(AUTOCONF_OK, ac.getAutoconfStatus());
+  TEST_ASSERT_TRUE(ac.getCapabilities().has(CAPABILITY_PRESET_TURBO));
+  run(ac, 10000);
+  // Verified in background without saving same data again
+  TEST_ASSERT_EQUAL_UINT32(2, sim.numCapabilitiesQueries);
+  TEST_ASSERT_TRUE(ac.getCapabilities().has(CAPABILITY_PRESET_TURBO));
+  TEST_ASSERT_EQUAL_UINT32(1, g_storage.numSaves);
+}
+
+void test_changed_capabilities_replace_cache() {
+  fillCache();
+  // Other model of same type and protocol
+  AirConditionerSim sim;
+  sim.capabilities[1] = CAPABILITIES_NO_TURBO;
+  sim.capabilitiesSize[1] = sizeof(CAPABILITIES_NO_TURBO);
+  AirConditioner ac;
+  start(ac, sim);
+  TEST_ASSERT_TRUE(ac.getCapabilities().has(CAPABILITY_PRESET_TURBO));
+  run(ac, 10000);
+  // Stale capability must not survive re-query
+  TEST_ASSERT_FALSE(ac.getCapabilities().has(CAPABILITY_PRESET_TURBO));
+  TEST_ASSERT_TRUE(ac.getCapabilities().has(CAPABILITY_SWING_MODES));
+  TEST_ASSERT_EQUAL_UINT32(2, g_storage.numSaves);
+  Capabilities cached;
+  uint32_t tag;
+  TEST_ASSERT_TRUE(cached.deserialize(g_storage.data, g_storage.size, tag));
+  TEST_ASSERT_TRUE(cached == ac.getCapabilities());
+}
+
+void test_failed_verification_keeps_cache() {
+  fillCache();
+  AirConditionerSim sim;
+  sim.capabilities[0] = nullptr;
+  AirConditioner ac;
+  start(ac, sim);
+  run(ac, 20000);
+  TEST_ASSERT_GREATER_THAN(0, sim.numCapabilitiesQueries);
+  TEST_ASSERT_EQUAL(AUTOCONF_OK, ac.getAutoconfStatus());
+  TEST_ASSERT_TRUE(ac.getCapabilities().has(CAPABILITY_PRESET_TURBO));
+  TEST_ASSERT_EQUAL_UINT32(1, g_storage.numSaves);
+}
+
+void test_known_serial_trusts_cache() {
+  fillCache(SERIAL);
+  AirConditionerSim sim;
+  AirConditioner ac;
+  start(ac, sim, SERIAL);
+  run(ac, 10000);
+  TEST_ASSERT_EQUAL_UINT32(0, sim.numCapabilitiesQueries);
+  TEST_ASSERT_TRUE(ac.getCapabilities().has(CAPABILITY_PRESET_TURBO));
+}
+
+void test_other_serial_verifies_cache() {
+  fillCache(SERIAL);
+  AirConditionerSim sim;
+  sim.capabilities[1] = CAPABILITIES_NO_TURBO;
+  sim.capabilitiesSize[1] = sizeof(CAPABILITIES_NO_TURBO);
+  AirConditioner ac;
+  start(ac, sim, OTHER_SERIAL);
+  run(ac, 10000);
+  TEST_ASSERT_EQUAL_UINT32(2, sim.numCapabilitiesQueries);
+  TEST_ASSERT_FALSE(ac.getCapabilities().has(CAPABILITY_PRESET_TURBO));
+}
+
+void setUp() {
+  host::setMillis(0);
+  g_storage.clear();
+}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_fill_cache);
+  RUN_TEST(test_unchanged_capabilities_are_kept);
+  RUN_TEST(test_changed_capabilities_replace_cache);
+  RUN_TEST(test_failed_verification_keeps_cache);
+  RUN_TEST(test_known_serial_trusts_cache);
+  RUN_TEST(test_other_serial_verifies_cache);
+  return UNITY_END();
+}
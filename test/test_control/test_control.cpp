@@ -0,0 +1,133 @@
+// Control commands: minimal frame sequences, single completion callback, failure of group
+#include <unity.h>
+#include "Appliance/AirConditioner/AirConditioner.h"
+#include "ApplianceSim.h"
+
+using namespace dudanov;
+using namespace dudanov::midea;
+using namespace dudanov::midea::ac;
+
+struct Completion {
+  void onComplete(bool success) {
+    ++this->numCalls;
+    this->success = success;
+  }
+  uint32_t numCalls{};
+  bool success{};
+};
+
+static void run(AirConditioner &ac, unsigned long ms) {
+  for (unsigned long n = 0; n < ms; ++n) {
+    host::advanceMillis(1);
+    ac.loop();
+  }
+}
+
+// Simulator reports cool mode, 21 °C, auto fan and no swing
+static void start(AirConditioner &ac, AirConditionerSim &sim) {
+  sim.setLatency(20);
+  ac.setStream(&sim);
+  ac.setup();
+  run(ac, 5000);
+  TEST_ASSERT_TRUE(ac.isReady());
+  TEST_ASSERT_EQUAL(Mode::MODE_COOL, ac.getMode());
+}
+
+static ControlCallback bindCompletion(Completion &completion) {
+  return ControlCallback::bind<&Completion::onComplete>(&completion);
+}
+
+void test_single_frame() {
+  AirConditionerSim sim;
+  AirConditioner ac;
+  start(ac, sim);
+  Control control;
+  control.mode = Mode::MODE_COOL;
+  control.targetTempTenths = 220;
+  control.fanMode = FanMode::FAN_LOW;
+  control.swingMode = SwingMode::SWING_OFF;
+  Completion completion;
+  ac.control(control, bindCompletion(completion));
+  run(ac, 5000);
+  TEST_ASSERT_EQUAL_UINT32(1, sim.numControls);
+  TEST_ASSERT_EQUAL_UINT32(1, completion.numCalls);
+  TEST_ASSERT_TRUE(completion.success);
+}
+
+void test_mode_with_preset() {
+  AirConditionerSim sim;
+  AirConditioner ac;
+  start(ac, sim);
+  // Preset is accepted only in already set mode
+  Control control;
+  control.mode = Mode::MODE_HEAT;
+  control.preset = Preset::PRESET_TURBO;
+  Completion completion;
+  ac.control(control, bindCompletion(completion));
+  run(ac, 5000);
+  TEST_ASSERT_EQUAL_UINT32(2, sim.numControls);
+  TEST_ASSERT_EQUAL_UINT32(0, sim.numDisplayToggles);
+  TEST_ASSERT_EQUAL_UINT32(1, completion.numCalls);
+  TEST_ASSERT_TRUE(completion.success);
+  // Display toggle adds one query frame
+  control.displayToggle = true;
+  ac.control(control, bindCompletion(completion));
+  run(ac, 5000);
+  TEST_ASSERT_EQUAL_UINT32(4, sim.numControls);
+  TEST_ASSERT_EQUAL_UINT32(1, sim.numDisplayToggles);
+  TEST_ASSERT_EQUAL_UINT32(2, completion.numCalls);
+  TEST_ASSERT_TRUE(completion.success);
+}
+
+void test_failed_middle_frame() {
+  AirConditionerSim sim;
+  AirConditioner ac;
+  start(ac, sim);
+  sim.maxAnsweredControls = 1;
+  Control control;
+  control.mode = Mode::MODE_HEAT;
+  control.preset = Preset::PRESET_TURBO;
+  control.displayToggle = true;
+  Completion completion;
+  ac.control(control, bindCompletion(completion));
+  run(ac, 20000);
+  TEST_ASSERT_EQUAL_UINT32(1, completion.numCalls);
+  TEST_ASSERT_FALSE(completion.success);
+  // Second frame is sent with its retries, rest of group is dropped
+  TEST_ASSERT_GREATER_THAN(1, sim.numControls);
+  TEST_ASSERT_EQUAL_UINT32(0, sim.numDisplayToggles);
+}
+
+void test_control_in_progress() {
+  AirConditionerSim sim;
+  AirConditioner ac;
+  start(ac, sim);
+  Control control;
+  control.targetTempTenths = 230;
+  Completion first;
+  Completion second;
+  ac.control(control, bindCompletion(first));
+  control.targetTempTenths = 240;
+  ac.control(control, bindCompletion(second));
+  // Rejected at once
+  TEST_ASSERT_EQUAL_UINT32(1, second.numCalls);
+  TEST_ASSERT_FALSE(second.success);
+  TEST_ASSERT_EQUAL_UINT32(0, first.numCalls);
+  run(ac, 5000);
+  TEST_ASSERT_EQUAL_UINT32(1, first.numCalls);
+  TEST_ASSERT_TRUE(first.success);
+  TEST_ASSERT_EQUAL_UINT32(1, sim.numControls);
+  TEST_ASSERT_EQUAL_UINT32(1, second.numCalls);
+}
+
+void setUp() { host::setMillis(0); }
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_single_frame);
+  RUN_TEST(test_mode_with_preset);
+  RUN_TEST(test_failed_middle_frame);
+  RUN_TEST(test_control_in_progress);
+  return UNITY_END();
+}
@@ -0,0 +1,74 @@
+// Dehumidifier: decoding of 0xC8 status and SET_STATUS(0x48) frames built from it
+#include <unity.h>
+#include "Appliance/Dehumidifier/Dehumidifier.h"
+#include "ApplianceSim.h"
+
+using namespace dudanov;
+using namespace dudanov::midea;
+using namespace dudanov::midea::dh;
+
+static void run(Dehumidifier &appliance, unsigned long ms) {
+  for (unsigned long n = 0; n < ms; ++n) {
+    host::advanceMillis(1);
+    appliance.loop();
+  }
+}
+
+void test_decode_status() {
+  const DehumidifierSim sim;
+  DhState state;
+  TEST_ASSERT_TRUE(DhDescriptor::decodeStatus(sim.status, sizeof(sim.status), state));
+  TEST_ASSERT_TRUE(state.power);
+  TEST_ASSERT_EQUAL_UINT8(MODE_SETPOINT, state.mode);
+  TEST_ASSERT_EQUAL_UINT8(FAN_HIGH, state.fanSpeed);
+  TEST_ASSERT_EQUAL_UINT8(50, state.targetHumidity);
+  TEST_ASSERT_EQUAL_UINT8(62, state.humidity);
+  TEST_ASSERT_EQUAL_INT16(200, state.temperature);
+  TEST_ASSERT_EQUAL_UINT8(100, state.tankLevel);
+  TEST_ASSERT_TRUE(state.isTankFull());
+  TEST_ASSERT_TRUE(state.ion);
+  TEST_ASSERT_FALSE(state.pump);
+  // Writable part is incomplete
+  TEST_ASSERT_FALSE(DhDescriptor::decodeStatus(sim.status, 9, state));
+}
+
+void test_control_frame() {
+  DehumidifierSim sim;
+  Dehumidifier appliance;
+  appliance.setStream(&sim);
+  appliance.setup();
+  run(appliance, 100);
+  TEST_ASSERT_TRUE(appliance.isReady());
+  TEST_ASSERT_EQUAL_UINT8(62, appliance.getHumidity());
+  TEST_ASSERT_TRUE(appliance.isTankFull());
+  Control control;
+  control.targetHumidity = 60;
+  control.fanSpeed = FAN_LOW;
+  appliance.control(control);
+  // Requests are spaced by period
+  run(appliance, 2000);
+  TEST_ASSERT_EQUAL_UINT32(1, sim.numControls);
+  // Writable bytes are copied from last status, beeper is enabled and off
+  const uint8_t expected[] = {0x48, 0x01 | 0x02, MODE_SETPOINT, FAN_LOW, 0, 0, 0, 60, 0, 0x40};
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, sim.control, sizeof(expected));
+  TEST_ASSERT_EQUAL_UINT8(FAN_LOW, appliance.getFanSpeed());
+  TEST_ASSERT_EQUAL_UINT8(60, appliance.getTargetHumidity());
+  // Setpoint is clamped to supported range
+  control = Control{};
+  control.targetHumidity = 95;
+  appliance.control(control);
+  run(appliance, 2000);
+  TEST_ASSERT_EQUAL_UINT32(2, sim.numControls);
+  TEST_ASSERT_EQUAL_UINT8(Dehumidifier::MAX_TARGET_HUMIDITY, sim.control[7]);
+  TEST_ASSERT_EQUAL_UINT8(FAN_LOW, sim.control[3]);
+}
+
+void setUp() { host::setMillis(0); }
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_decode_status);
+  RUN_TEST(test_control_frame);
+  return UNITY_END();
+}
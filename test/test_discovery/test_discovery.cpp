@@ -0,0 +1,101 @@
+// Discovery of appliance type, protocol and serial number, its caching in storage
+#include <unity.h>
+#include "Appliance/Discovery.h"
+#include "ApplianceSim.h"
+#include "MemoryStorage.h"
+
+using namespace dudanov;
+using namespace dudanov::midea;
+
+static const uint8_t SERIAL_NUMBER[] = {'0', '0', '0', '0', 'Q', '1', '2', '3', '4', '5', '6', '7'};
+
+/// Dehumidifier of protocol 2 answering GET_ELECTRONIC_ID broadcast
+class IdentitySim : public ApplianceSim {
+ public:
+  IdentitySim() : ApplianceSim(0xA1, 2) {}
+  uint32_t numBroadcasts{};
+
+ protected:
+  void m_onRequest(uint8_t type, const uint8_t *payload, uint8_t size) override {
+    if (type != 0x07)
+      return;
+    ++this->numBroadcasts;
+    this->reply(0x07, SERIAL_NUMBER, sizeof(SERIAL_NUMBER));
+  }
+};
+
+static MemoryStorage g_storage;
+
+static void run(Discovery &discovery, unsigned long ms) {
+  for (unsigned long n = 0; n < ms; ++n) {
+    host::advanceMillis(1);
+    discovery.loop();
+  }
+}
+
+static void assertInfo(const ApplianceInfo &info) {
+  TEST_ASSERT_EQUAL_HEX8(DEHUMIDIFIER, info.type);
+  TEST_ASSERT_EQUAL_UINT8(2, info.protocol);
+  TEST_ASSERT_EQUAL_UINT8(sizeof(SERIAL_NUMBER), info.serialSize);
+  TEST_ASSERT_EQUAL_MEMORY(SERIAL_NUMBER, info.serialNumber, sizeof(SERIAL_NUMBER));
+}
+
+void test_discovery_is_cached() {
+  IdentitySim sim;
+  {
+    Discovery discovery;
+    discovery.setStream(&sim);
+    discovery.setStorage(&g_storage);
+    discovery.setup();
+    run(discovery, 2000);
+    TEST_ASSERT_TRUE(discovery.isDone());
+    TEST_ASSERT_TRUE(discovery.isReady());
+    assertInfo(discovery.getInfo());
+    TEST_ASSERT_EQUAL_UINT32(1, sim.numBroadcasts);
+    TEST_ASSERT_EQUAL_UINT32(1, g_storage.numSaves);
+  }
+  Discovery discovery;
+  discovery.setStream(&sim);
+  discovery.setStorage(&g_storage);
+  discovery.setup();
+  // Restored before any frame is exchanged
+  TEST_ASSERT_TRUE(discovery.isDone());
+  TEST_ASSERT_TRUE(discovery.isReady());
+  assertInfo(discovery.getInfo());
+  run(discovery, 5000);
+  TEST_ASSERT_EQUAL_UINT32(1, sim.numBroadcasts);
+  TEST_ASSERT_EQUAL_UINT32(1, g_storage.numSaves);
+}
+
+void test_force_ignores_cache() {
+  IdentitySim sim;
+  {
+    Discovery discovery;
+    discovery.setStream(&sim);
+    discovery.setStorage(&g_storage);
+    discovery.setup();
+    run(discovery, 2000);
+  }
+  Discovery discovery;
+  discovery.setStream(&sim);
+  discovery.setStorage(&g_storage);
+  discovery.setForce(true);
+  discovery.setup();
+  TEST_ASSERT_FALSE(discovery.isDone());
+  run(discovery, 2000);
+  TEST_ASSERT_TRUE(discovery.isDone());
+  TEST_ASSERT_EQUAL_UINT32(2, sim.numBroadcasts);
+}
+
+void setUp() {
+  host::setMillis(0);
+  g_storage.clear();
+}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_discovery_is_cached);
+  RUN_TEST(test_force_ignores_cache);
+  return UNITY_END();
+}
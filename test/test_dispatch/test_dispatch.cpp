@@ -0,0 +1,202 @@
+// Callback dispatch: Delegate vs std::function, request queue priority classes
+#include <unity.h>
+#include <chrono>
+#include <functional>
+#include "Appliance/ApplianceBase.h"
+#include "Helpers/Memory.h"
+#include "ApplianceSim.h"
+
+using namespace dudanov;
+using namespace dudanov::midea;
+
+static const uint32_t NUM_CALLS = 1000000;
+
+class Handlers {
+ public:
+  ResponseStatus onData(FrameData data) {
+    this->sum += data.size();
+    return RESPONSE_OK;
+  }
+  void onSuccess() { ++this->numSuccess; }
+  void onValue(uint32_t value) { this->sum += value; }
+  uint32_t sum{};
+  uint32_t numSuccess{};
+};
+
+template<typename Fn> static double nsPerCall(Fn fn) {
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < NUM_CALLS; ++n)
+    fn();
+  const std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - start;
+  return time.count() / NUM_CALLS;
+}
+
+static void report(const char *name, double delegate, double function) {
+  char buf[128];
+  snprintf(buf, sizeof(buf), "%s: Delegate %.1f ns, std::function %.1f ns", name, delegate, function);
+  TEST_MESSAGE(buf);
+}
+
+void test_delegate_calls() {
+  Handlers handlers;
+  auto onData = ResponseHandler::bind<&Handlers::onData>(&handlers);
+  auto onSuccess = Handler([&handlers]() { handlers.onSuccess(); });
+  TEST_ASSERT_TRUE(onData != nullptr);
+  TEST_ASSERT_EQUAL(RESPONSE_OK, onData(FrameData({1, 2, 3})));
+  onSuccess();
+  TEST_ASSERT_EQUAL_UINT32(3, handlers.sum);
+  TEST_ASSERT_EQUAL_UINT32(1, handlers.numSuccess);
+  TEST_ASSERT_FALSE(Handler() != nullptr);
+}
+
+void test_delegate_list_is_bounded() {
+  uint32_t sum = 0;
+  DelegateList<void(uint32_t), 2> list;
+  uint32_t *ptr = &sum;
+  TEST_ASSERT_TRUE(list.add([ptr](uint32_t value) { *ptr += value; }));
+  TEST_ASSERT_TRUE(list.add([ptr](uint32_t value) { *ptr += 2 * value; }));
+  TEST_ASSERT_FALSE(list.add([ptr](uint32_t value) { *ptr += 4 * value; }));
+  list.call(10u);
+  TEST_ASSERT_EQUAL_UINT32(30, sum);
+}
+
+void test_dispatch_cost() {
+  using Callback = Delegate<void(uint32_t)>;
+  Handlers handlers;
+  // Bound once, called many times: observer and timer callbacks
+  auto delegate = Callback::bind<&Handlers::onValue>(&handlers);
+  std::function<void(uint32_t)> function = std::bind(&Handlers::onValue, &handlers, std::placeholders::_1);
+  const double delegateCall = nsPerCall([&]() { delegate(1); });
+  const double functionCall = nsPerCall([&]() { function(1); });
+  report("call", delegateCall, functionCall);
+  // Bound for each request: request handlers
+  const double delegateBind = nsPerCall([&]() { Callback::bind<&Handlers::onValue>(&handlers)(1); });
+  const double functionBind = nsPerCall([&]() {
+    std::function<void(uint32_t)> fn = std::bind(&Handlers::onValue, &handlers, std::placeholders::_1);
+    fn(1);
+  });
+  report("bind and call", delegateBind, functionBind);
+  TEST_ASSERT_EQUAL_UINT32(4 * NUM_CALLS, handlers.sum);
+}
+
+void test_delegate_bind_allocations() {
+  using Callback = Delegate<void(uint32_t)>;
+  TEST_ASSERT_TRUE_MESSAGE(AllocTracker::isEnabled(), "Build with -DMIDEA_TRACK_ALLOCATIONS");
+  Handlers handlers;
+  uint32_t *sum = &handlers.sum;
+  AllocTracker::reset();
+  // Request handlers are bound for each request
+  for (uint32_t n = 0; n < 100; ++n) {
+    Callback::bind<&Handlers::onValue>(&handlers)(n);
+    Callback lambda = [sum, n](uint32_t value) { *sum += value + n; };
+    lambda(n);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, AllocTracker::getStats().numAllocs);
+  // std::function stores bound member function on heap
+  std::function<void(uint32_t)> function = std::bind(&Handlers::onValue, &handlers, std::placeholders::_1);
+  function(1);
+  char buf[64];
+  snprintf(buf, sizeof(buf), "std::bind to std::function, heap allocations: %u",
+           static_cast<unsigned>(AllocTracker::getStats().numAllocs));
+  TEST_MESSAGE(buf);
+}
+
+// Answers every query with its own payload
+class EchoSim : public ApplianceSim {
+ public:
+  uint8_t order[16]{};
+  uint8_t numOrder{};
+
+ protected:
+  void m_onRequest(uint8_t type, const uint8_t *payload, uint8_t size) override {
+    if (type != 0x03)
+      return;
+    if (this->numOrder < sizeof(this->order))
+      this->order[this->numOrder++] = payload[1];
+    this->reply(type, payload, size);
+  }
+};
+
+class TestAppliance : public ApplianceBase {
+ public:
+  TestAppliance() : ApplianceBase(AIR_CONDITIONER) {}
+  void query(uint8_t tag, RequestPriority priority, ResponseHandler onData, Handler onSuccess = nullptr) {
+    FrameData data({0x41, tag});
+    data.appendCRC();
+    this->m_queueRequest(DEVICE_QUERY, std::move(data), onData, onSuccess, nullptr, priority);
+  }
+};
+
+static void run(TestAppliance &appliance, unsigned long ms) {
+  for (unsigned long n = 0; n < ms; ++n) {
+    host::advanceMillis(1);
+    appliance.loop();
+  }
+}
+
+void test_priority_order() {
+  EchoSim sim;
+  sim.setLatency(5);
+  TestAppliance appliance;
+  Handlers handlers;
+  appliance.setStream(&sim);
+  appliance.setPeriod(10);
+  appliance.setup();
+  run(appliance, 100);
+  const auto onData = ResponseHandler::bind<&Handlers::onData>(&handlers);
+  const auto onSuccess = Handler::bind<&Handlers::onSuccess>(&handlers);
+  // First request is sent at once, the rest wait in queue
+  appliance.query(1, PRIORITY_POLL, onData, onSuccess);
+  appliance.loop();
+  appliance.query(2, PRIORITY_POLL, onData, onSuccess);
+  appliance.query(3, PRIORITY_QUERY, onData, onSuccess);
+  appliance.query(4, PRIORITY_CONTROL, onData, onSuccess);
+  appliance.query(5, PRIORITY_QUERY, onData, onSuccess);
+  appliance.query(6, PRIORITY_CONTROL, onData, onSuccess);
+  run(appliance, 500);
+  TEST_ASSERT_EQUAL_UINT32(6, handlers.numSuccess);
+  const uint8_t expected[] = {1, 4, 6, 3, 5, 2};
+  TEST_ASSERT_EQUAL_UINT8(sizeof(expected), sim.numOrder);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, sim.order, sizeof(expected));
+}
+
+void test_queue_dispatch_cost() {
+  static const uint32_t NUM_REQUESTS = 10000;
+  EchoSim sim;
+  TestAppliance appliance;
+  Handlers handlers;
+  appliance.setStream(&sim);
+  appliance.setPeriod(1);
+  appliance.setup();
+  run(appliance, 100);
+  const auto onData = ResponseHandler::bind<&Handlers::onData>(&handlers);
+  const auto onSuccess = Handler::bind<&Handlers::onSuccess>(&handlers);
+  static const RequestPriority PRIORITIES[] = {PRIORITY_POLL, PRIORITY_QUERY, PRIORITY_CONTROL};
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < NUM_REQUESTS; ++n) {
+    appliance.query(n % 200, PRIORITIES[n % 3], onData, onSuccess);
+    if (n % 8 == 7)
+      run(appliance, 16);
+  }
+  while (handlers.numSuccess < NUM_REQUESTS && millis() < 1000000)
+    run(appliance, 1);
+  const std::chrono::duration<double, std::micro> time = std::chrono::steady_clock::now() - start;
+  char buf[96];
+  snprintf(buf, sizeof(buf), "queue: %.2f us per request with 3 priority classes", time.count() / NUM_REQUESTS);
+  TEST_MESSAGE(buf);
+  TEST_ASSERT_EQUAL_UINT32(NUM_REQUESTS, handlers.numSuccess);
+}
+
+void setUp() { host::setMillis(0); }
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_delegate_calls);
+  RUN_TEST(test_delegate_list_is_bounded);
+  RUN_TEST(test_dispatch_cost);
+  RUN_TEST(test_delegate_bind_allocations);
+  RUN_TEST(test_priority_order);
+  RUN_TEST(test_queue_dispatch_cost);
+  return UNITY_END();
+}
@@ -0,0 +1,116 @@
+// Energy meter persistence: restore over reboot with wall clock only, clock jumps
+#include <unity.h>
+#include "Appliance/AirConditioner/AirConditioner.h"
+#include "ApplianceSim.h"
+#include "MemoryStorage.h"
+
+using namespace dudanov;
+using namespace dudanov::midea;
+using namespace dudanov::midea::ac;
+
+static const uint32_t HOUR = EnergyMeter::BUCKET_TIME;
+// Wall clock, s
+static uint32_t g_now;
+static MemoryStorage g_storage;
+
+static uint32_t wallClock() { return g_now; }
+
+// Runs appliance until next power usage query is answered
+static void waitPowerQuery(AirConditioner &ac, AirConditionerSim &sim, uint32_t counter) {
+  sim.powerUsage = counter;
+  const uint32_t numQueries = sim.numPowerQueries;
+  const unsigned long start = millis();
+  while (sim.numPowerQueries == numQueries && millis() - start < 120000) {
+    host::advanceMillis(1);
+    ac.loop();
+  }
+  TEST_ASSERT_NOT_EQUAL(numQueries, sim.numPowerQueries);
+  for (unsigned n = 0; n < 100; ++n) {
+    host::advanceMillis(1);
+    ac.loop();
+  }
+}
+
+static void start(AirConditioner &ac, AirConditionerSim &sim, bool isWallClock) {
+  ac.setStream(&sim);
+  if (isWallClock)
+    ac.setClock(ClockSource(wallClock));
+  ac.setEnergyStorage(&g_storage);
+  ac.setup();
+}
+
+// Fills storage with meter of 1 kWh in last hour before `g_now`
+static void fillStorage() {
+  AirConditionerSim sim;
+  AirConditioner ac;
+  start(ac, sim, true);
+  g_now = 10 * HOUR + HOUR - 1800;
+  waitPowerQuery(ac, sim, 1000);
+  g_now += 3600;
+  waitPowerQuery(ac, sim, 1010);
+  TEST_ASSERT_EQUAL_UINT32(1000, ac.getEnergyMeter().getTotal());
+  // First sample and new hour
+  TEST_ASSERT_EQUAL_UINT32(2, g_storage.numSaves);
+}
+
+void test_wall_clock_spreads_downtime_energy() {
+  fillStorage();
+  AirConditionerSim sim;
+  AirConditioner ac;
+  start(ac, sim, true);
+  TEST_ASSERT_EQUAL_UINT32(1000, ac.getEnergyMeter().getTotal());
+  // 3 kWh consumed during 3 hours of downtime
+  g_now += 3 * HOUR;
+  waitPowerQuery(ac, sim, 1040);
+  const EnergyMeter &meter = ac.getEnergyMeter();
+  TEST_ASSERT_EQUAL_UINT32(4000, meter.getTotal());
+  TEST_ASSERT_UINT16_WITHIN(1, 500, meter.getHour(0));
+  TEST_ASSERT_UINT16_WITHIN(1, 1000, meter.getHour(1));
+  TEST_ASSERT_UINT16_WITHIN(1, 1000, meter.getHour(2));
+  TEST_ASSERT_UINT16_WITHIN(1, 1000, meter.getHour(3));
+  TEST_ASSERT_EQUAL_UINT32(3, g_storage.numSaves);
+}
+
+void test_uptime_clock_ignores_storage() {
+  fillStorage();
+  const uint32_t numSaves = g_storage.numSaves;
+  AirConditionerSim sim;
+  AirConditioner ac;
+  start(ac, sim, false);
+  // Buckets of wall clock are not mixed with uptime
+  TEST_ASSERT_EQUAL_UINT32(0, ac.getEnergyMeter().getTotal());
+  waitPowerQuery(ac, sim, 1040);
+  waitPowerQuery(ac, sim, 1050);
+  TEST_ASSERT_EQUAL_UINT32(1000, ac.getEnergyMeter().getTotal());
+  TEST_ASSERT_EQUAL_UINT32(0, ac.getEnergyMeter().getBucketStart());
+  TEST_ASSERT_EQUAL_UINT32(numSaves, g_storage.numSaves);
+}
+
+void test_multi_year_gap() {
+  EnergyMeter meter;
+  // Clock is set from 1970 to 2026 between samples
+  meter.addSample(100, 1000);
+  const uint32_t now = 1790000000UL;
+  meter.addSample(now, 2000);
+  TEST_ASSERT_EQUAL_UINT32(100000, meter.getTotal());
+  TEST_ASSERT_EQUAL_UINT32(now - now % HOUR, meter.getBucketStart());
+  // Share of 7 days in 56 years
+  TEST_ASSERT_UINT32_WITHIN(5, 35, meter.getLastHours(EnergyMeter::NUM_BUCKETS));
+  meter.addSample(now + HOUR, 2010);
+  TEST_ASSERT_EQUAL_UINT32(101000, meter.getTotal());
+  TEST_ASSERT_UINT16_WITHIN(1, 1000, meter.getHour(0) + meter.getHour(1));
+}
+
+void setUp() {
+  host::setMillis(0);
+  g_storage.clear();
+}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_wall_clock_spreads_downtime_energy);
+  RUN_TEST(test_uptime_clock_ignores_storage);
+  RUN_TEST(test_multi_year_gap);
+  return UNITY_END();
+}
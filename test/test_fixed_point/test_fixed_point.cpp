@@ -0,0 +1,189 @@
+// Fixed-point decoding of status: exact round trip against former float implementation
+#include <unity.h>
+#include <chrono>
+#include "Appliance/AirConditioner/AirConditioner.h"
+
+using namespace dudanov::midea;
+using namespace dudanov::midea::ac;
+
+/* FORMER FLOAT IMPLEMENTATION */
+
+static float floatTargetTemp(const uint8_t *data) {
+  uint8_t tmp = (data[2] & 15) + 16;
+  uint8_t tmpNew = data[13] & 31;
+  if (tmpNew)
+    tmp = tmpNew + 12;
+  float temp = static_cast<float>(tmp);
+  if (data[2] & 16)
+    temp += 0.5F;
+  return temp;
+}
+
+static void floatSetTargetTemp(uint8_t *data, float temp) {
+  uint8_t tmp = static_cast<uint8_t>(temp * 4.0F) + 1;
+  uint8_t integer = tmp / 4;
+  data[18] = (data[18] & ~31) | ((integer - 12) & 31);
+  integer -= 16;
+  if (integer < 1 || integer > 14)
+    integer = 1;
+  data[2] = (data[2] & ~31) | ((((tmp & 2) << 3) | integer) & 31);
+}
+
+static float floatTemp(int integer, int decimal, bool fahrenheits) {
+  integer -= 50;
+  if (!fahrenheits && decimal > 0)
+    return static_cast<float>(integer / 2) + static_cast<float>(decimal) * ((integer >= 0) ? 0.1F : -0.1F);
+  if (decimal >= 5)
+    return static_cast<float>(integer / 2) + ((integer >= 0) ? 0.5F : -0.5F);
+  return static_cast<float>(integer) * 0.5F;
+}
+
+static uint8_t bcd2u8(uint8_t bcd) { return (bcd >> 4) * 10 + (bcd & 15); }
+
+static float floatPowerUsage(const uint8_t *data) {
+  uint32_t power = 0;
+  const uint8_t *ptr = data + 18;
+  for (uint32_t weight = 1;; weight *= 100, --ptr) {
+    power += weight * bcd2u8(*ptr);
+    if (weight == 10000)
+      return static_cast<float>(power) * 0.1F;
+  }
+}
+
+static uint8_t g_status[24] = {0xC0, 0x01, 0x45, 0x66, 0x7F, 0x7F, 0x00, 0x30, 0x00, 0x00, 0x00, 0x62,
+                               0x55, 0x00, 0x00, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+static StatusData makeStatus() { return StatusData(FrameData(g_status, sizeof(g_status))); }
+
+void test_target_temp() {
+  for (unsigned byte2 = 0; byte2 < 32; ++byte2) {
+    for (unsigned byte13 = 0; byte13 < 32; ++byte13) {
+      g_status[2] = (g_status[2] & ~31) | byte2;
+      g_status[13] = byte13;
+      const StatusData status = makeStatus();
+      const float expected = floatTargetTemp(g_status);
+      TEST_ASSERT_EQUAL_INT16(lroundf(expected * 10.0F), status.getTargetTempTenths());
+      TEST_ASSERT_TRUE(expected == status.getTargetTemp());
+    }
+  }
+}
+
+void test_set_target_temp() {
+  for (int16_t tenths = 120; tenths <= 350; ++tenths) {
+    StatusData status;
+    uint8_t expected[24];
+    memcpy(expected, status.data(), sizeof(expected));
+    floatSetTargetTemp(expected, static_cast<float>(tenths) / 10.0F);
+    status.setTargetTempTenths(tenths);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, status.data(), sizeof(expected));
+  }
+}
+
+void test_indoor_outdoor_temp() {
+  for (unsigned integer = 0; integer < 256; ++integer) {
+    for (unsigned decimal = 0; decimal < 16; ++decimal) {
+      for (bool fahrenheits : {false, true}) {
+        g_status[10] = fahrenheits ? 4 : 0;
+        g_status[11] = integer;
+        g_status[12] = 255 - integer;
+        g_status[15] = decimal | ((15 - decimal) << 4);
+        const StatusData status = makeStatus();
+        const float indoor = floatTemp(integer, decimal, fahrenheits);
+        const float outdoor = floatTemp(255 - integer, 15 - decimal, fahrenheits);
+        TEST_ASSERT_EQUAL_INT16(lroundf(indoor * 10.0F), status.getIndoorTempTenths());
+        TEST_ASSERT_EQUAL_INT16(lroundf(outdoor * 10.0F), status.getOutdoorTempTenths());
+        // Float wrappers may differ from former results in last bit only
+        TEST_ASSERT_FLOAT_WITHIN(1e-5F, indoor, status.getIndoorTemp());
+        TEST_ASSERT_FLOAT_WITHIN(1e-5F, outdoor, status.getOutdoorTemp());
+      }
+    }
+  }
+  g_status[10] = 0;
+}
+
+void test_power_usage() {
+  uint8_t data[24]{};
+  for (unsigned n = 0; n < 100000; ++n) {
+    const unsigned value = n * 9 + n / 7;
+    data[16] = ((value / 100000 % 10) << 4) | (value / 10000 % 10);
+    data[17] = ((value / 1000 % 10) << 4) | (value / 100 % 10);
+    data[18] = ((value / 10 % 10) << 4) | (value % 10);
+    TEST_ASSERT_EQUAL_UINT32(value % 1000000, StatusData::decodePowerUsage(data));
+    TEST_ASSERT_EQUAL_UINT32(lroundf(floatPowerUsage(data) * 10.0F), StatusData::decodePowerUsage(data));
+  }
+}
+
+void test_control_target_temp() {
+  Control control;
+  TEST_ASSERT_FALSE(control.getTargetTempTenths().hasValue());
+  control.targetTemp = 23.5F;
+  TEST_ASSERT_EQUAL_INT16(235, control.getTargetTempTenths().value());
+  // Integer field has priority
+  control.targetTempTenths = 240;
+  TEST_ASSERT_EQUAL_INT16(240, control.getTargetTempTenths().value());
+  // Later float value replaces earlier integer one
+  Control later;
+  later.targetTemp = 21.0F;
+  Control merged;
+  merged.targetTempTenths = 250;
+  merged.merge(later);
+  TEST_ASSERT_EQUAL_INT16(210, merged.getTargetTempTenths().value());
+  TEST_ASSERT_FALSE(merged.targetTemp.hasValue());
+}
+
+// Status with mutable payload
+class TestStatus : public StatusData {
+ public:
+  TestStatus() : StatusData(FrameData(g_status, sizeof(g_status))) {}
+  void setByte(uint8_t idx, uint8_t value) { this->m_data[idx] = value; }
+};
+
+template<typename Fn> static double nsPerStatus(Fn fn) {
+  static const unsigned NUM_PASSES = 200;
+  TestStatus status;
+  volatile int32_t sink = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned pass = 0; pass < NUM_PASSES; ++pass) {
+    for (unsigned n = 0; n < 256; ++n) {
+      status.setByte(11, n);
+      status.setByte(15, n);
+      sink = sink + fn(status);
+    }
+  }
+  const std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - start;
+  return time.count() / (NUM_PASSES * 256);
+}
+
+void test_decode_cost() {
+  // Target, indoor and outdoor temperatures as used by change detection
+  const double tenths = nsPerStatus([](const StatusData &status) -> int32_t {
+    return status.getTargetTempTenths() + status.getIndoorTempTenths() + status.getOutdoorTempTenths();
+  });
+  const double floats = nsPerStatus([](const StatusData &status) -> int32_t {
+    const uint8_t *data = status.data();
+    const float sum = floatTargetTemp(data) + floatTemp(data[11], data[15] & 15, data[10] & 4) +
+                      floatTemp(data[12], data[15] >> 4, data[10] & 4);
+    return static_cast<int32_t>(sum);
+  });
+  char buf[160];
+  snprintf(buf, sizeof(buf), "decode of 3 temperatures: fixed point %.1f ns, float %.1f ns (host FPU, no soft-float)",
+           tenths, floats);
+  TEST_MESSAGE(buf);
+  snprintf(buf, sizeof(buf), "size: 3 temperatures and power usage %u bytes as fixed point, %u bytes as float",
+           static_cast<unsigned>(3 * sizeof(int16_t) + sizeof(uint32_t)), static_cast<unsigned>(4 * sizeof(float)));
+  TEST_MESSAGE(buf);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_target_temp);
+  RUN_TEST(test_set_target_temp);
+  RUN_TEST(test_indoor_outdoor_temp);
+  RUN_TEST(test_power_usage);
+  RUN_TEST(test_control_target_temp);
+  RUN_TEST(test_decode_cost);
+  return UNITY_END();
+}
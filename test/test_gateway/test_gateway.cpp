@@ -0,0 +1,125 @@
+// Gateway: many air conditioners on pty pairs driven from one thread, removal from appliance callbacks
+#include <unity.h>
+#include <ctime>
+#include <memory>
+#include <pty.h>
+#include "Appliance/AirConditioner/AirConditioner.h"
+#include "Gateway/Gateway.h"
+#include "SimLink.h"
+
+using namespace dudanov;
+using namespace dudanov::midea;
+using namespace dudanov::midea::ac;
+
+static const unsigned NUM_APPLIANCES = 256;
+// Status poll of every second is sent in one loop and its response is read in another
+static const unsigned MAX_LOOPS_PER_SECOND = 3;
+
+struct Node {
+  AirConditionerSim sim;
+  AirConditioner ac;
+  std::unique_ptr<SimLink> link;
+};
+
+// Appliance on slave end of new pty, simulator on its master end
+static void addNode(Gateway &gateway, Node &node) {
+  int master, slave;
+  char path[64];
+  TEST_ASSERT_EQUAL_INT(0, openpty(&master, &slave, path, nullptr, nullptr));
+  node.link.reset(new SimLink(node.sim, master));
+  TEST_ASSERT_TRUE(gateway.addSerial(node.ac, path));
+  close(slave);
+}
+
+// Polls gateway and links until all appliances are ready. Returns elapsed time, ms.
+static unsigned long runUntilReady(Gateway &gateway, Node *nodes, unsigned num, unsigned long timeout) {
+  const unsigned long start = millis();
+  for (unsigned numReady = 0; numReady < num && millis() - start < timeout;) {
+    gateway.poll(1);
+    numReady = 0;
+    for (unsigned n = 0; n < num; ++n) {
+      nodes[n].link->pump();
+      numReady += nodes[n].ac.isReady();
+    }
+  }
+  return millis() - start;
+}
+
+void test_many_appliances() {
+  Gateway gateway;
+  std::unique_ptr<Node[]> nodes(new Node[NUM_APPLIANCES]);
+  for (unsigned n = 0; n < NUM_APPLIANCES; ++n)
+    addNode(gateway, nodes[n]);
+  TEST_ASSERT_EQUAL_UINT32(NUM_APPLIANCES, gateway.size());
+  const unsigned long time = runUntilReady(gateway, nodes.get(), NUM_APPLIANCES, 10000);
+  // Steady polling: appliance loops run only on their deadlines and input
+  const unsigned long start = millis();
+  const auto cpuStart = std::clock();
+  unsigned numLoops = 0;
+  while (millis() - start < 3000) {
+    numLoops += gateway.poll(1);
+    for (unsigned n = 0; n < NUM_APPLIANCES; ++n)
+      nodes[n].link->pump();
+  }
+  const unsigned long elapsed = millis() - start;
+  const double cpu = 100.0 * (std::clock() - cpuStart) / CLOCKS_PER_SEC / elapsed * 1000;
+  const double loopsPerSecond = 1000.0 * numLoops / NUM_APPLIANCES / elapsed;
+  char buf[160];
+  snprintf(buf, sizeof(buf),
+           "%u appliances on pty: ready in %lu ms, then %.2f loops per appliance per second, %.1f%% CPU with simulators",
+           NUM_APPLIANCES, time, loopsPerSecond, cpu);
+  TEST_MESSAGE(buf);
+  // Idle appliances are not looped between their deadlines
+  TEST_ASSERT_LESS_OR_EQUAL(MAX_LOOPS_PER_SECOND, loopsPerSecond);
+  TEST_ASSERT_GREATER_OR_EQUAL(1, loopsPerSecond);
+  for (unsigned n = 0; n < NUM_APPLIANCES; ++n) {
+    TEST_ASSERT_TRUE(nodes[n].ac.isReady());
+    TEST_ASSERT_EQUAL_FLOAT(24.3F, nodes[n].ac.getIndoorTemp());
+    TEST_ASSERT_EQUAL_UINT32(0, nodes[n].link->numLost);
+  }
+}
+
+struct Remover {
+  Gateway *gateway;
+  Node *nodes;
+};
+
+void test_remove_from_callback() {
+  static const unsigned NUM = 4;
+  Gateway gateway;
+  Node nodes[NUM];
+  for (unsigned n = 0; n < NUM; ++n)
+    addNode(gateway, nodes[n]);
+  // First ready appliance removes itself and next one while gateway dispatches events
+  static Remover remover;
+  remover = {&gateway, nodes};
+  for (unsigned n = 0; n < 2; ++n) {
+    nodes[n].ac.addOnReadyCallback([](uint32_t) {
+      remover.gateway->remove(remover.nodes[0].ac);
+      remover.gateway->remove(remover.nodes[1].ac);
+    });
+  }
+  runUntilReady(gateway, nodes, NUM, 5000);
+  TEST_ASSERT_EQUAL_UINT32(NUM - 2, gateway.size());
+  TEST_ASSERT_TRUE(nodes[2].ac.isReady());
+  TEST_ASSERT_TRUE(nodes[3].ac.isReady());
+  // Removed appliances are never run again
+  const uint32_t numRequests = nodes[0].sim.getNumRequests() + nodes[1].sim.getNumRequests();
+  for (unsigned n = 0; n < 200; ++n) {
+    gateway.poll(1);
+    for (Node &node : nodes)
+      node.link->pump();
+  }
+  TEST_ASSERT_EQUAL_UINT32(numRequests, nodes[0].sim.getNumRequests() + nodes[1].sim.getNumRequests());
+  TEST_ASSERT_GREATER_THAN(0, nodes[2].sim.numStatusQueries);
+}
+
+void setUp() { host::useRealClock(); }
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_many_appliances);
+  RUN_TEST(test_remove_from_callback);
+  return UNITY_END();
+}
@@ -0,0 +1,151 @@
+// Link state machine: degradation, offline probing with back-off, failing controls and recovery
+#include <unity.h>
+#include "Appliance/AirConditioner/AirConditioner.h"
+#include "ApplianceSim.h"
+
+using namespace dudanov;
+using namespace dudanov::midea;
+using namespace dudanov::midea::ac;
+
+static const uint32_t TIMEOUT = 100;
+static const uint32_t MIN_PROBE = 1000;
+static const uint32_t MAX_PROBE = 4000;
+
+// Air conditioner which may stop answering. Remembers times of requests.
+class LinkSim : public AirConditionerSim {
+ public:
+  bool isMuted{};
+  unsigned long times[32]{};
+  uint8_t numTimes{};
+
+ protected:
+  void m_onRequest(uint8_t type, const uint8_t *payload, uint8_t size) override {
+    if (this->numTimes < 32)
+      this->times[this->numTimes++] = millis();
+    if (!this->isMuted)
+      AirConditionerSim::m_onRequest(type, payload, size);
+  }
+};
+
+struct LinkLog {
+  void onState(LinkState state) {
+    if (this->num < sizeof(this->states))
+      this->states[this->num++] = state;
+  }
+  LinkState states[8]{};
+  uint8_t num{};
+};
+
+static LinkLog g_log;
+
+static void run(AirConditioner &ac, unsigned long ms) {
+  for (unsigned long n = 0; n < ms; ++n) {
+    host::advanceMillis(1);
+    ac.loop();
+  }
+}
+
+static void start(AirConditioner &ac, LinkSim &sim) {
+  sim.setLatency(10);
+  ac.setStream(&sim);
+  ac.setTimeout(TIMEOUT);
+  ac.setNumAttempts(1);
+  ac.setOfflineThreshold(3);
+  ac.setProbeInterval(MIN_PROBE, MAX_PROBE);
+  ac.addOnLinkStateCallback(OnLinkStateCallback::bind<&LinkLog::onState>(&g_log));
+  ac.setup();
+  run(ac, 5000);
+  TEST_ASSERT_TRUE(ac.isReady());
+  TEST_ASSERT_EQUAL(LINK_ONLINE, ac.getLinkState());
+}
+
+// Mutes appliance and runs until it is offline
+static void goOffline(AirConditioner &ac, LinkSim &sim) {
+  sim.isMuted = true;
+  for (unsigned n = 0; n < 60000 && ac.getLinkState() != LINK_OFFLINE; ++n)
+    run(ac, 1);
+  TEST_ASSERT_EQUAL(LINK_OFFLINE, ac.getLinkState());
+}
+
+void test_online_degraded_offline() {
+  LinkSim sim;
+  AirConditioner ac;
+  start(ac, sim);
+  goOffline(ac, sim);
+  TEST_ASSERT_EQUAL_UINT8(2, g_log.num);
+  TEST_ASSERT_EQUAL(LINK_DEGRADED, g_log.states[0]);
+  TEST_ASSERT_EQUAL(LINK_OFFLINE, g_log.states[1]);
+  TEST_ASSERT_EQUAL_UINT32(3, ac.getLinkStats().numTimeouts);
+}
+
+void test_probe_back_off() {
+  LinkSim sim;
+  AirConditioner ac;
+  start(ac, sim);
+  goOffline(ac, sim);
+  sim.numTimes = 0;
+  run(ac, 20000);
+  // Probe follows failure of previous one after doubled interval up to limit
+  static const uint32_t INTERVALS[] = {2 * MIN_PROBE, MAX_PROBE, MAX_PROBE, MAX_PROBE};
+  TEST_ASSERT_GREATER_OR_EQUAL(5, sim.numTimes);
+  for (uint8_t n = 0; n < 4; ++n)
+    TEST_ASSERT_UINT32_WITHIN(10, INTERVALS[n] + TIMEOUT, sim.times[n + 1] - sim.times[n]);
+  TEST_ASSERT_EQUAL(LINK_OFFLINE, ac.getLinkState());
+}
+
+struct Completion {
+  void onComplete(bool success) {
+    ++this->numCalls;
+    this->success = success;
+  }
+  uint32_t numCalls{};
+  bool success{};
+};
+
+void test_offline_fails_controls() {
+  LinkSim sim;
+  AirConditioner ac;
+  start(ac, sim);
+  goOffline(ac, sim);
+  Control control;
+  control.targetTempTenths = 240;
+  Completion completion;
+  ac.control(control, ControlCallback::bind<&Completion::onComplete>(&completion));
+  run(ac, 5);
+  TEST_ASSERT_EQUAL_UINT32(1, completion.numCalls);
+  TEST_ASSERT_FALSE(completion.success);
+  TEST_ASSERT_EQUAL_UINT32(0, sim.numControls);
+}
+
+void test_any_frame_restores_online() {
+  LinkSim sim;
+  AirConditioner ac;
+  start(ac, sim);
+  goOffline(ac, sim);
+  // Unsolicited notify between probes
+  const uint8_t notify[] = {0xA0, 0x01, 0x02, 0x03};
+  sim.reply(0x05, notify, sizeof(notify), 0);
+  run(ac, 5);
+  TEST_ASSERT_EQUAL(LINK_ONLINE, ac.getLinkState());
+  TEST_ASSERT_EQUAL(LINK_ONLINE, g_log.states[g_log.num - 1]);
+  // Answered probe restores it as well
+  goOffline(ac, sim);
+  sim.isMuted = false;
+  run(ac, 2 * MAX_PROBE);
+  TEST_ASSERT_EQUAL(LINK_ONLINE, ac.getLinkState());
+}
+
+void setUp() {
+  host::setMillis(0);
+  g_log = LinkLog{};
+}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_online_degraded_offline);
+  RUN_TEST(test_probe_back_off);
+  RUN_TEST(test_offline_fails_controls);
+  RUN_TEST(test_any_frame_restores_online);
+  return UNITY_END();
+}
@@ -0,0 +1,117 @@
+// Answers to QUERY_NETWORK(0x63) from cached network status and its refresh
+#include <unity.h>
+#include "Appliance/ApplianceBase.h"
+#include "ApplianceSim.h"
+
+using namespace dudanov;
+using namespace dudanov::midea;
+
+class TestAppliance : public ApplianceBase {
+ public:
+  TestAppliance() : ApplianceBase(AIR_CONDITIONER) {}
+};
+
+/// Keeps payload of last QUERY_NETWORK answer
+class NetworkSim : public ApplianceSim {
+ public:
+  uint32_t numAnswers{};
+  uint8_t answer[MAX_FRAME]{};
+  /// Sends query and runs appliance until it is answered
+  void query(TestAppliance &appliance) {
+    const uint8_t payload[] = {0x00};
+    const uint32_t numAnswers = this->numAnswers;
+    this->reply(0x63, payload, sizeof(payload));
+    for (unsigned n = 0; n < 10 && this->numAnswers == numAnswers; ++n) {
+      host::advanceMillis(1);
+      appliance.loop();
+    }
+    TEST_ASSERT_EQUAL_UINT32(numAnswers + 1, this->numAnswers);
+  }
+
+ protected:
+  void m_onRequest(uint8_t type, const uint8_t *payload, uint8_t size) override {
+    if (type != 0x63)
+      return;
+    ++this->numAnswers;
+    memcpy(this->answer, payload, size);
+  }
+};
+
+static void run(TestAppliance &appliance, unsigned long ms) {
+  for (unsigned long n = 0; n < ms; ++n) {
+    host::advanceMillis(1);
+    appliance.loop();
+  }
+}
+
+// Checks IP (reversed in payload), signal strength and connection flag of answer
+static void assertAnswer(const NetworkSim &sim, const NetworkStatus &status) {
+  TEST_ASSERT_EQUAL_UINT8(status.signalStrength, sim.answer[2]);
+  TEST_ASSERT_EQUAL_UINT8(status.ip[3], sim.answer[3]);
+  TEST_ASSERT_EQUAL_UINT8(status.ip[2], sim.answer[4]);
+  TEST_ASSERT_EQUAL_UINT8(status.ip[1], sim.answer[5]);
+  TEST_ASSERT_EQUAL_UINT8(status.ip[0], sim.answer[6]);
+  TEST_ASSERT_EQUAL_UINT8(status.connected ? 0 : 1, sim.answer[8]);
+}
+
+void test_answer_follows_status() {
+  const NetworkStatus home{{192, 168, 1, 10}, 3, true};
+  const NetworkStatus lost{{10, 0, 0, 2}, 1, false};
+  StaticNetworkProvider provider(home);
+  NetworkSim sim;
+  TestAppliance appliance;
+  appliance.setStream(&sim);
+  appliance.setNetworkProvider(&provider);
+  appliance.setup();
+  run(appliance, 100);
+  sim.query(appliance);
+  assertAnswer(sim, home);
+  provider.setStatus(lost);
+  sim.query(appliance);
+  assertAnswer(sim, lost);
+}
+
+void test_provider_swap_with_equal_revision() {
+  const NetworkStatus first{{192, 168, 1, 10}, 3, true};
+  const NetworkStatus second{{172, 16, 0, 5}, 2, true};
+  StaticNetworkProvider provider1(first);
+  StaticNetworkProvider provider2(second);
+  NetworkSim sim;
+  TestAppliance appliance;
+  appliance.setStream(&sim);
+  appliance.setNetworkProvider(&provider1);
+  appliance.setup();
+  run(appliance, 100);
+  sim.query(appliance);
+  assertAnswer(sim, first);
+  // Both revisions are zero
+  appliance.setNetworkProvider(&provider2);
+  sim.query(appliance);
+  assertAnswer(sim, second);
+}
+
+void test_null_provider_restores_default() {
+  const NetworkStatus custom{{192, 168, 1, 10}, 1, false};
+  StaticNetworkProvider provider(custom);
+  NetworkSim sim;
+  TestAppliance appliance;
+  appliance.setStream(&sim);
+  appliance.setNetworkProvider(&provider);
+  appliance.setup();
+  run(appliance, 100);
+  appliance.setNetworkProvider(nullptr);
+  run(appliance, 10);
+  sim.query(appliance);
+  assertAnswer(sim, StaticNetworkProvider().getStatus());
+}
+
+void setUp() { host::setMillis(0); }
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_answer_follows_status);
+  RUN_TEST(test_provider_swap_with_equal_revision);
+  RUN_TEST(test_null_provider_restores_default);
+  return UNITY_END();
+}
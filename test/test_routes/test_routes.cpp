@@ -0,0 +1,83 @@
+// Routing of unsolicited frames: report and notify handlers, fallback to `m_onRequest()`
+#include <unity.h>
+#include "Appliance/ApplianceBase.h"
+#include "ApplianceSim.h"
+
+using namespace dudanov;
+using namespace dudanov::midea;
+
+class TestAppliance : public ApplianceBase {
+ public:
+  TestAppliance() : ApplianceBase(AIR_CONDITIONER) {}
+  bool addRoute(FrameType type) { return this->m_addRoute(type, FrameHandler::bind<&TestAppliance::m_onRouted>(this)); }
+  uint32_t numReports{};
+  uint32_t numNotifies{};
+  uint32_t numRequests{};
+  uint8_t lastPayload{};
+
+ protected:
+  void m_onRouted(const Frame &frame) {
+    if (frame.hasType(DEVICE_REPORT))
+      ++this->numReports;
+    else if (frame.hasType(DEVICE_NOTIFY))
+      ++this->numNotifies;
+    this->lastPayload = frame.getData().data()[0];
+  }
+  void m_onRequest(const Frame &frame) override {
+    ++this->numRequests;
+    this->lastPayload = frame.getData().data()[0];
+  }
+};
+
+static void run(TestAppliance &appliance, unsigned long ms) {
+  for (unsigned long n = 0; n < ms; ++n) {
+    host::advanceMillis(1);
+    appliance.loop();
+  }
+}
+
+void test_routes() {
+  ApplianceSim sim;
+  TestAppliance appliance;
+  appliance.setStream(&sim);
+  TEST_ASSERT_TRUE(appliance.addRoute(DEVICE_REPORT));
+  TEST_ASSERT_TRUE(appliance.addRoute(DEVICE_NOTIFY));
+  appliance.setup();
+  run(appliance, 100);
+  const uint8_t report[] = {0xC0, 0x01};
+  const uint8_t notify[] = {0xA1, 0x02};
+  const uint8_t unknown[] = {0x5A, 0x03};
+  sim.reply(DEVICE_REPORT, report, sizeof(report));
+  run(appliance, 10);
+  TEST_ASSERT_EQUAL_UINT32(1, appliance.numReports);
+  TEST_ASSERT_EQUAL_HEX8(0xC0, appliance.lastPayload);
+  sim.reply(DEVICE_NOTIFY, notify, sizeof(notify));
+  run(appliance, 10);
+  TEST_ASSERT_EQUAL_UINT32(1, appliance.numNotifies);
+  TEST_ASSERT_EQUAL_HEX8(0xA1, appliance.lastPayload);
+  // Unrouted frame falls through
+  sim.reply(0x0A, unknown, sizeof(unknown));
+  run(appliance, 10);
+  TEST_ASSERT_EQUAL_UINT32(1, appliance.numRequests);
+  TEST_ASSERT_EQUAL_HEX8(0x5A, appliance.lastPayload);
+  TEST_ASSERT_EQUAL_UINT32(1, appliance.numReports);
+  TEST_ASSERT_EQUAL_UINT32(1, appliance.numNotifies);
+}
+
+void test_route_table_is_bounded() {
+  TestAppliance appliance;
+  static const FrameType TYPES[] = {DEVICE_REPORT, DEVICE_NOTIFY, DEVICE_CONTROL, DEVICE_QUERY};
+  for (FrameType type : TYPES)
+    TEST_ASSERT_TRUE(appliance.addRoute(type));
+  TEST_ASSERT_FALSE(appliance.addRoute(GET_ELECTRONIC_ID));
+}
+
+void setUp() { host::setMillis(0); }
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_routes);
+  RUN_TEST(test_route_table_is_bounded);
+  return UNITY_END();
+}
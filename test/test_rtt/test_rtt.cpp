@@ -0,0 +1,148 @@
+// Round-trip time estimation: estimator arithmetic, Karn's rule and adaptive timeout limits
+#include <unity.h>
+#include "Appliance/ApplianceBase.h"
+#include "Helpers/RttEstimator.h"
+#include "ApplianceSim.h"
+
+using namespace dudanov;
+using namespace dudanov::midea;
+
+void test_estimator() {
+  RttEstimator rtt;
+  TEST_ASSERT_FALSE(rtt.hasSamples());
+  // First sample: SRTT = RTT, RTTVAR = RTT / 2
+  rtt.addSample(100);
+  TEST_ASSERT_EQUAL_UINT32(100, rtt.getSmoothed());
+  TEST_ASSERT_EQUAL_UINT32(50, rtt.getDeviation());
+  TEST_ASSERT_EQUAL_UINT32(300, rtt.getTimeout(0, UINT32_MAX));
+  // RTTVAR = 3/4 * 50 + 1/4 * |200 - 100| = 62.5, SRTT = 7/8 * 100 + 1/8 * 200 = 112.5
+  rtt.addSample(200);
+  TEST_ASSERT_EQUAL_UINT32(112, rtt.getSmoothed());
+  TEST_ASSERT_EQUAL_UINT32(62, rtt.getDeviation());
+  TEST_ASSERT_EQUAL_UINT32(362, rtt.getTimeout(0, UINT32_MAX));
+  // RTTVAR = 3/4 * 62.5 + 1/4 * 12.5 = 50, SRTT = 7/8 * 112.5 + 1/8 * 100 = 110.9
+  rtt.addSample(100);
+  TEST_ASSERT_EQUAL_UINT32(111, rtt.getSmoothed());
+  TEST_ASSERT_EQUAL_UINT32(50, rtt.getDeviation());
+  TEST_ASSERT_EQUAL_UINT32(311, rtt.getTimeout(0, UINT32_MAX));
+  TEST_ASSERT_EQUAL_UINT32(100, rtt.getMin());
+  TEST_ASSERT_EQUAL_UINT32(200, rtt.getMax());
+  TEST_ASSERT_EQUAL_UINT32(3, rtt.getNumSamples());
+  // Clamps
+  TEST_ASSERT_EQUAL_UINT32(400, rtt.getTimeout(400, 5000));
+  TEST_ASSERT_EQUAL_UINT32(200, rtt.getTimeout(0, 200));
+  // Constant RTT: deviation decays, SRTT converges
+  for (unsigned n = 0; n < 100; ++n)
+    rtt.addSample(40);
+  TEST_ASSERT_UINT32_WITHIN(1, 40, rtt.getSmoothed());
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, rtt.getDeviation());
+  rtt.reset();
+  TEST_ASSERT_FALSE(rtt.hasSamples());
+}
+
+// Echoes queries. First attempts of some requests are lost. Remembers times of requests.
+class LossySim : public ApplianceSim {
+ public:
+  uint8_t numLost{};
+  unsigned long times[8]{};
+  uint8_t numTimes{};
+
+ protected:
+  void m_onRequest(uint8_t type, const uint8_t *payload, uint8_t size) override {
+    if (type != 0x03)
+      return;
+    if (this->numTimes < 8)
+      this->times[this->numTimes++] = millis();
+    if (this->numLost) {
+      --this->numLost;
+      return;
+    }
+    this->reply(type, payload, size);
+  }
+};
+
+class TestAppliance : public ApplianceBase {
+ public:
+  TestAppliance() : ApplianceBase(AIR_CONDITIONER) {}
+  void query() {
+    FrameData data({0x41, 0x00});
+    data.appendCRC();
+    this->m_queueRequest(DEVICE_QUERY, std::move(data), [this](FrameData data) -> ResponseStatus {
+      ++this->numDone;
+      return RESPONSE_OK;
+    });
+  }
+  uint32_t numDone{};
+};
+
+static void start(TestAppliance &appliance, LossySim &sim, unsigned long latency) {
+  sim.setLatency(latency);
+  appliance.setStream(&sim);
+  appliance.setPeriod(1000);
+  appliance.setAdaptiveTimeout(true);
+  appliance.setTimeoutLimits(150, 1000);
+  appliance.setup();
+}
+
+// Runs single query to completion
+static void runQuery(TestAppliance &appliance) {
+  const uint32_t done = appliance.numDone + 1;
+  appliance.query();
+  for (unsigned n = 0; n < 20000 && appliance.numDone < done; ++n) {
+    host::advanceMillis(1);
+    appliance.loop();
+  }
+  TEST_ASSERT_EQUAL_UINT32(done, appliance.numDone);
+}
+
+void test_karn_rule() {
+  LossySim sim;
+  TestAppliance appliance;
+  start(appliance, sim, 50);
+  // Response to retransmission is not sampled
+  sim.numLost = 1;
+  runQuery(appliance);
+  TEST_ASSERT_EQUAL_UINT32(0, appliance.getLinkStats().numSamples);
+  TEST_ASSERT_EQUAL_UINT32(1, appliance.getLinkStats().numTimeouts);
+  runQuery(appliance);
+  LinkStats stats = appliance.getLinkStats();
+  TEST_ASSERT_EQUAL_UINT32(1, stats.numSamples);
+  TEST_ASSERT_UINT32_WITHIN(2, 50, stats.srtt);
+  // 50 + 4 * 25
+  TEST_ASSERT_UINT32_WITHIN(4, 150, stats.timeout);
+  // Timeout is doubled on each retry
+  sim.numTimes = 0;
+  sim.numLost = 2;
+  runQuery(appliance);
+  TEST_ASSERT_EQUAL_UINT8(3, sim.numTimes);
+  TEST_ASSERT_UINT32_WITHIN(4, stats.timeout, sim.times[1] - sim.times[0]);
+  TEST_ASSERT_UINT32_WITHIN(8, 2 * stats.timeout, sim.times[2] - sim.times[1]);
+  TEST_ASSERT_EQUAL_UINT32(1, appliance.getLinkStats().numSamples);
+}
+
+void test_timeout_limits() {
+  LossySim fastSim;
+  TestAppliance fast;
+  start(fast, fastSim, 10);
+  runQuery(fast);
+  // 10 + 4 * 5 is below lower limit
+  TEST_ASSERT_EQUAL_UINT32(150, fast.getLinkStats().timeout);
+
+  LossySim slowSim;
+  TestAppliance slow;
+  start(slow, slowSim, 800);
+  runQuery(slow);
+  // 800 + 4 * 400 is above upper limit
+  TEST_ASSERT_EQUAL_UINT32(1000, slow.getLinkStats().timeout);
+}
+
+void setUp() { host::setMillis(0); }
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_estimator);
+  RUN_TEST(test_karn_rule);
+  RUN_TEST(test_timeout_limits);
+  return UNITY_END();
+}
@@ -0,0 +1,105 @@
+// Socket transport: request engine over socketpair, dropped frames fail requests at once
+#include <unity.h>
+#include <sys/socket.h>
+#include "Appliance/ApplianceBase.h"
+#include "Transport/SocketTransport.h"
+#include "SimLink.h"
+
+using namespace dudanov;
+using namespace dudanov::midea;
+
+// Answers every query with its own payload
+class EchoSim : public ApplianceSim {
+ protected:
+  void m_onRequest(uint8_t type, const uint8_t *payload, uint8_t size) override {
+    if (type == 0x03)
+      this->reply(type, payload, size);
+  }
+};
+
+class TestAppliance : public ApplianceBase {
+ public:
+  TestAppliance() : ApplianceBase(AIR_CONDITIONER) {}
+  void query(uint8_t tag) {
+    FrameData data({0x41, tag});
+    data.appendCRC();
+    this->m_queueRequest(
+        DEVICE_QUERY, std::move(data),
+        [this, tag](FrameData data) -> ResponseStatus {
+          if (data.data()[1] != tag)
+            return RESPONSE_WRONG;
+          ++this->numDone;
+          return RESPONSE_OK;
+        },
+        nullptr, [this]() { ++this->numErrors; });
+  }
+  uint32_t numDone{};
+  uint32_t numErrors{};
+};
+
+static int g_fds[2];
+
+static void run(TestAppliance &appliance, SimLink &link, unsigned long ms) {
+  for (unsigned long n = 0; n < ms; ++n) {
+    host::advanceMillis(1);
+    appliance.loop();
+    link.pump();
+  }
+}
+
+static void start(TestAppliance &appliance, SocketTransport &transport) {
+  TEST_ASSERT_EQUAL_INT(0, socketpair(AF_UNIX, SOCK_STREAM, 0, g_fds));
+  TEST_ASSERT_TRUE(transport.open(g_fds[0]));
+  appliance.setTransport(&transport);
+  appliance.setPeriod(5);
+  appliance.setup();
+}
+
+void test_query_response() {
+  EchoSim sim;
+  sim.setLatency(10);
+  SocketTransport transport;
+  TestAppliance appliance;
+  start(appliance, transport);
+  SimLink link(sim, g_fds[1]);
+  for (uint8_t n = 0; n < 8; ++n)
+    appliance.query(n);
+  run(appliance, link, 1000);
+  TEST_ASSERT_EQUAL_UINT32(8, appliance.numDone);
+  TEST_ASSERT_EQUAL_UINT32(0, appliance.numErrors);
+  TEST_ASSERT_EQUAL_UINT32(0, appliance.getLinkStats().numTimeouts);
+  TEST_ASSERT_EQUAL_UINT32(0, transport.getPending());
+}
+
+void test_full_buffer_fails_request() {
+  EchoSim sim;
+  SocketTransport transport;
+  TestAppliance appliance;
+  start(appliance, transport);
+  // Peer doesn't read: fill socket and then send buffer
+  uint8_t junk[64]{};
+  while (::write(g_fds[0], junk, sizeof(junk)) > 0) {
+  }
+  while (transport.write(junk, sizeof(junk)) == sizeof(junk)) {
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, transport.write(junk, sizeof(junk)));
+  appliance.query(1);
+  for (unsigned n = 0; n < 10; ++n) {
+    host::advanceMillis(1);
+    appliance.loop();
+  }
+  // Failed at once, not after response timeout
+  TEST_ASSERT_EQUAL_UINT32(1, appliance.numErrors);
+  TEST_ASSERT_EQUAL_UINT32(0, appliance.getLinkStats().numTimeouts);
+  close(g_fds[1]);
+}
+
+void setUp() { host::setMillis(0); }
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_query_response);
+  RUN_TEST(test_full_buffer_fails_request);
+  return UNITY_END();
+}
@@ -0,0 +1,156 @@
+// State codec: full and delta state, capabilities, forward compatibility and corrupted messages
+#include <unity.h>
+#include "Appliance/AirConditioner/StateCodec.h"
+#include "ApplianceSim.h"
+
+using namespace dudanov::midea;
+using namespace dudanov::midea::ac;
+
+static AcState makeState() {
+  AcState state;
+  state.sequence = 300;
+  state.mode = Mode::MODE_HEAT;
+  state.preset = Preset::PRESET_SLEEP;
+  state.fanMode = FanMode::FAN_HIGH;
+  state.swingMode = SwingMode::SWING_BOTH;
+  state.targetTemp = 235;
+  state.indoorTemp = 212;
+  state.outdoorTemp = -75;
+  state.humiditySetpoint = 45;
+  state.powerUsage = 123456;
+  return state;
+}
+
+static void assertStateEqual(const AcState &expected, const AcState &actual) {
+  TEST_ASSERT_EQUAL_UINT16(expected.sequence, actual.sequence);
+  TEST_ASSERT_EQUAL_UINT16(0, expected.diff(actual));
+  TEST_ASSERT_EQUAL_INT16(expected.outdoorTemp, actual.outdoorTemp);
+}
+
+void test_full_state() {
+  const AcState state = makeState();
+  uint8_t data[StateCodec::MAX_STATE_SIZE];
+  const size_t size = StateCodec::encode(state, data, sizeof(data));
+  TEST_ASSERT_GREATER_THAN(0, size);
+  TEST_ASSERT_EQUAL_UINT8(MESSAGE_STATE, data[0]);
+  // Full snapshot replaces every field
+  AcState received;
+  received.timestamp = 1000;
+  received.indoorTemp = 100;
+  TEST_ASSERT_TRUE(StateCodec::decode(data, size, received));
+  assertStateEqual(state, received);
+  TEST_ASSERT_EQUAL_UINT32(1000, received.timestamp);
+  TEST_ASSERT_EQUAL_UINT16(state.diff(AcState{}), received.changeMask);
+  // Buffer too small
+  TEST_ASSERT_EQUAL_UINT32(0, StateCodec::encode(state, data, size - 1));
+}
+
+void test_delta_state() {
+  const AcState prev = makeState();
+  AcState state = prev;
+  state.sequence = prev.sequence + 1;
+  state.indoorTemp = 215;
+  state.powerUsage = 123457;
+  uint8_t full[StateCodec::MAX_STATE_SIZE];
+  uint8_t delta[StateCodec::MAX_STATE_SIZE];
+  const size_t fullSize = StateCodec::encode(state, full, sizeof(full));
+  const size_t deltaSize = StateCodec::encodeDelta(state, prev, delta, sizeof(delta));
+  TEST_ASSERT_EQUAL_UINT8(MESSAGE_DELTA, delta[0]);
+  TEST_ASSERT_LESS_THAN(fullSize, deltaSize);
+  AcState received = prev;
+  TEST_ASSERT_TRUE(StateCodec::decode(delta, deltaSize, received));
+  assertStateEqual(state, received);
+  TEST_ASSERT_EQUAL_UINT16(CHANGE_INDOOR_TEMP | CHANGE_POWER_USAGE, received.changeMask);
+}
+
+void test_delta_of_other_base_is_rejected() {
+  const AcState prev = makeState();
+  AcState state = prev;
+  state.sequence = prev.sequence + 1;
+  state.mode = Mode::MODE_COOL;
+  uint8_t data[StateCodec::MAX_STATE_SIZE];
+  const size_t size = StateCodec::encodeDelta(state, prev, data, sizeof(data));
+  // Receiver has missed one message
+  AcState received = prev;
+  received.sequence = prev.sequence - 1;
+  received.mode = Mode::MODE_DRY;
+  TEST_ASSERT_FALSE(StateCodec::decode(data, size, received));
+  TEST_ASSERT_EQUAL_UINT16(prev.sequence - 1, received.sequence);
+  TEST_ASSERT_EQUAL(Mode::MODE_DRY, received.mode);
+}
+
+void test_unknown_fields_are_skipped() {
+  const AcState state = makeState();
+  uint8_t data[StateCodec::MAX_STATE_SIZE + 8];
+  size_t size = StateCodec::encode(state, data, sizeof(data));
+  // Field of newer schema with multibyte value after type byte
+  static const uint8_t FIELD[] = {200, 0xFF, 0xFF, 0x03};
+  memmove(data + 1 + sizeof(FIELD), data + 1, size - 1);
+  memcpy(data + 1, FIELD, sizeof(FIELD));
+  size += sizeof(FIELD);
+  AcState received;
+  TEST_ASSERT_TRUE(StateCodec::decode(data, size, received));
+  assertStateEqual(state, received);
+}
+
+void test_truncated_varint_is_rejected() {
+  const AcState state = makeState();
+  uint8_t data[StateCodec::MAX_STATE_SIZE];
+  const size_t size = StateCodec::encode(state, data, sizeof(data));
+  // Power usage is last field: ID and 3 bytes of varint
+  TEST_ASSERT_EQUAL_UINT8(FIELD_POWER_USAGE, data[size - 4]);
+  for (size_t cut = 1; cut <= 3; ++cut) {
+    AcState received = makeState();
+    received.powerUsage = 1;
+    TEST_ASSERT_FALSE(StateCodec::decode(data, size - cut, received));
+    // Corrupted message leaves state intact
+    TEST_ASSERT_EQUAL_UINT32(1, received.powerUsage);
+  }
+  // Varint longer than 5 bytes
+  const uint8_t overlong[] = {MESSAGE_STATE, FIELD_MODE, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01};
+  AcState received;
+  TEST_ASSERT_FALSE(StateCodec::decode(overlong, sizeof(overlong), received));
+}
+
+static Capabilities makeCapabilities() {
+  Capabilities capabilities;
+  capabilities.read(FrameData(AirConditionerSim::CAPABILITIES, sizeof(AirConditionerSim::CAPABILITIES)));
+  capabilities.read(FrameData(AirConditionerSim::CAPABILITIES_NEXT, sizeof(AirConditionerSim::CAPABILITIES_NEXT)));
+  return capabilities;
+}
+
+void test_capabilities() {
+  const Capabilities capabilities = makeCapabilities();
+  TEST_ASSERT_TRUE(capabilities.has(CAPABILITY_PRESET_TURBO));
+  uint8_t data[StateCodec::MAX_CAPABILITIES_SIZE];
+  const size_t size = StateCodec::encode(capabilities, data, sizeof(data));
+  TEST_ASSERT_GREATER_THAN(0, size);
+  TEST_ASSERT_EQUAL_UINT8(MESSAGE_CAPABILITIES, data[0]);
+  Capabilities received;
+  TEST_ASSERT_TRUE(StateCodec::decode(data, size, received));
+  TEST_ASSERT_TRUE(capabilities == received);
+  TEST_ASSERT_EQUAL_UINT8(capabilities.size(), received.size());
+  TEST_ASSERT_TRUE(received.has(CAPABILITY_PRESET_TURBO));
+  // Truncated message leaves capabilities intact
+  Capabilities other;
+  TEST_ASSERT_FALSE(StateCodec::decode(data, size - 1, other));
+  TEST_ASSERT_FALSE(other.has(CAPABILITY_PRESET_TURBO));
+  // State message is not capabilities
+  const size_t stateSize = StateCodec::encode(makeState(), data, sizeof(data));
+  TEST_ASSERT_FALSE(StateCodec::decode(data, stateSize, other));
+  TEST_ASSERT_EQUAL_UINT32(0, StateCodec::encode(capabilities, data, size - 1));
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_full_state);
+  RUN_TEST(test_delta_state);
+  RUN_TEST(test_delta_of_other_base_is_rejected);
+  RUN_TEST(test_unknown_fields_are_skipped);
+  RUN_TEST(test_truncated_varint_is_rejected);
+  RUN_TEST(test_capabilities);
+  return UNITY_END();
+}
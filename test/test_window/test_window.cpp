@@ -0,0 +1,181 @@
+// Windowed pipelining over simulated link with fixed latency
+#include <unity.h>
+#include "Appliance/ApplianceBase.h"
+#include "ApplianceSim.h"
+
+using namespace dudanov;
+using namespace dudanov::midea;
+
+static const unsigned long LATENCY = 50;
+static const uint8_t NUM_REQUESTS = 40;
+
+// Query carrying rolling message ID
+class TaggedQueryData : public FrameData {
+ public:
+  TaggedQueryData(uint8_t tag) : FrameData({0x41, tag, FrameData::m_getID()}) {
+    this->m_hasID = true;
+    this->appendCRC();
+  }
+};
+
+// Answers queries with their tag and echoed message ID. Responses to even tags may be delayed.
+class PipelineSim : public ApplianceSim {
+ public:
+  bool isReordering{};
+  /// Query with this tag is never answered
+  int silentTag{-1};
+  /// Query with this tag is answered after `lateLatency`
+  int lateTag{-1};
+  unsigned long lateLatency{};
+
+ protected:
+  void m_onRequest(uint8_t type, const uint8_t *payload, uint8_t size) override {
+    if (type != 0x03 || payload[0] != 0x41 || payload[1] == this->silentTag)
+      return;
+    const uint8_t response[] = {0xC5, payload[1], payload[size - 1]};
+    const bool isDelayed = this->isReordering && payload[1] % 2 == 0;
+    if (payload[1] == this->lateTag)
+      this->reply(type, response, sizeof(response), this->lateLatency);
+    else
+      this->reply(type, response, sizeof(response), isDelayed ? 3 * LATENCY : LATENCY);
+  }
+};
+
+class TestAppliance : public ApplianceBase {
+ public:
+  TestAppliance() : ApplianceBase(AIR_CONDITIONER) {}
+  void query(uint8_t tag) {
+    this->m_queueRequest(DEVICE_QUERY, TaggedQueryData(tag), [this, tag](FrameData data) -> ResponseStatus {
+      if (!data.hasID(0xC5))
+        return RESPONSE_WRONG;
+      if (data.data()[1] != tag)
+        ++this->numMismatched;
+      ++this->numDone;
+      return RESPONSE_OK;
+    }, nullptr, [this]() { ++this->numErrors; });
+  }
+  void beginGroup() { this->m_beginGroup(); }
+  void endGroup() { this->m_endGroup(); }
+  uint32_t numDone{};
+  uint32_t numMismatched{};
+  uint32_t numErrors{};
+};
+
+static void setupLink(TestAppliance &appliance, PipelineSim &sim, uint8_t window) {
+  sim.setLatency(LATENCY);
+  appliance.setStream(&sim);
+  appliance.setPeriod(5);
+  appliance.setWindow(window);
+  appliance.setup();
+}
+
+// Time to complete requests, ms
+static unsigned long runRequests(TestAppliance &appliance, uint8_t first, uint8_t num) {
+  const unsigned long start = millis();
+  const uint32_t done = appliance.numDone + num;
+  for (uint8_t n = 0; n < num; ++n)
+    appliance.query(first + n);
+  while (appliance.numDone < done && millis() - start < 60000) {
+    host::advanceMillis(1);
+    appliance.loop();
+  }
+  return millis() - start;
+}
+
+void test_window_speedup() {
+  PipelineSim stopAndWaitSim;
+  TestAppliance stopAndWait;
+  setupLink(stopAndWait, stopAndWaitSim, 1);
+  const unsigned long stopAndWaitTime = runRequests(stopAndWait, 0, NUM_REQUESTS);
+  TEST_ASSERT_EQUAL_UINT32(NUM_REQUESTS, stopAndWait.numDone);
+  TEST_ASSERT_EQUAL_UINT8(1, stopAndWaitSim.getMaxPending());
+
+  PipelineSim windowSim;
+  TestAppliance window;
+  setupLink(window, windowSim, 4);
+  const unsigned long windowTime = runRequests(window, 0, NUM_REQUESTS);
+  TEST_ASSERT_EQUAL_UINT32(NUM_REQUESTS, window.numDone);
+  TEST_ASSERT_EQUAL_UINT8(4, windowSim.getMaxPending());
+
+  char buf[96];
+  snprintf(buf, sizeof(buf), "%u requests, %lu ms latency: window=1 %lu ms, window=4 %lu ms", NUM_REQUESTS, LATENCY,
+           stopAndWaitTime, windowTime);
+  TEST_MESSAGE(buf);
+  TEST_ASSERT_GREATER_OR_EQUAL(3 * windowTime, stopAndWaitTime);
+  TEST_ASSERT_EQUAL_UINT32(0, stopAndWait.numMismatched);
+  TEST_ASSERT_EQUAL_UINT32(0, window.numMismatched);
+}
+
+void test_out_of_order_responses_are_matched_by_id() {
+  PipelineSim sim;
+  TestAppliance appliance;
+  setupLink(appliance, sim, 4);
+  // Appliance answers in order until echo of message IDs is learned
+  runRequests(appliance, 0, 4);
+  sim.isReordering = true;
+  runRequests(appliance, 4, NUM_REQUESTS);
+  TEST_ASSERT_EQUAL_UINT32(NUM_REQUESTS + 4, appliance.numDone);
+  TEST_ASSERT_EQUAL_UINT32(0, appliance.numMismatched);
+  const LinkStats stats = appliance.getLinkStats();
+  TEST_ASSERT_EQUAL_UINT32(0, stats.numTimeouts);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.numStale);
+}
+
+void test_unrelated_timeout_keeps_group() {
+  PipelineSim sim;
+  sim.silentTag = 100;
+  TestAppliance appliance;
+  setupLink(appliance, sim, 4);
+  // Learn echo of message IDs, so responses are matched strictly
+  runRequests(appliance, 0, 4);
+  // Unanswered request is in flight next to group head, group tail waits in queue
+  appliance.query(100);
+  appliance.beginGroup();
+  for (uint8_t tag = 1; tag <= 3; ++tag)
+    appliance.query(tag);
+  appliance.endGroup();
+  for (unsigned n = 0; n < 20000 && appliance.numDone + appliance.numErrors < 8; ++n) {
+    host::advanceMillis(1);
+    appliance.loop();
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, appliance.numErrors);
+  TEST_ASSERT_EQUAL_UINT32(7, appliance.numDone);
+  TEST_ASSERT_EQUAL_UINT32(0, appliance.numMismatched);
+  TEST_ASSERT_GREATER_THAN(0, appliance.getLinkStats().numTimeouts);
+}
+
+void test_late_response_is_stale() {
+  PipelineSim sim;
+  TestAppliance appliance;
+  setupLink(appliance, sim, 1);
+  runRequests(appliance, 0, 4);
+  appliance.setTimeout(200);
+  appliance.setNumAttempts(1);
+  // Response to timed out request arrives while next request of same type waits for its own
+  sim.lateTag = 50;
+  sim.lateLatency = 220;
+  appliance.query(50);
+  appliance.query(51);
+  for (unsigned n = 0; n < 1000 && appliance.numDone + appliance.numErrors < 6; ++n) {
+    host::advanceMillis(1);
+    appliance.loop();
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, appliance.numErrors);
+  TEST_ASSERT_EQUAL_UINT32(5, appliance.numDone);
+  TEST_ASSERT_EQUAL_UINT32(0, appliance.numMismatched);
+  const LinkStats stats = appliance.getLinkStats();
+  TEST_ASSERT_EQUAL_UINT32(1, stats.numTimeouts);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.numStale);
+}
+
+void setUp() { host::setMillis(0); }
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_window_speedup);
+  RUN_TEST(test_out_of_order_responses_are_matched_by_id);
+  RUN_TEST(test_unrelated_timeout_keeps_group);
+  RUN_TEST(test_late_response_is_stale);
+  return UNITY_END();
+}